@@ -15,88 +15,409 @@
 /// equation systems. We here translated the definition to parity games,
 /// assuming that the relative order between vertices in the game is the same
 /// as the relative order between equations in the underlying equation system.
+///
+/// The nested alternation depth follows the recursive definition instead:
+/// an SCC is split by removing its vertices of highest priority, and the
+/// depth increases whenever the highest priority of a nested SCC has a
+/// different parity.
 
 #ifndef ALTERNATION_DEPTH_H
 #define ALTERNATION_DEPTH_H
 
-#include <boost/graph/strong_components.hpp>
-#include <boost/graph/topological_sort.hpp>
+#include <algorithm>
+#include <vector>
 #include "cpplogging/logger.h"
+#include "csr.h"
+#include "parallel.h"
+#include "priority_compression.h"
+#include "scc_decomposition.h"
+
+/// \brief The order of vertices within an SCC used to determine nesting.
+enum alternation_depth_ordering
+{
+  vertex_index_ordering, ///< the order of the vertex indices [CKS93]
+  priority_ordering      ///< the order of the priorities
+};
+
+struct alternation_depth_statistics_t
+{
+  size_t depth;                  ///< Maximal alternation depth of an SCC.
+  std::vector<size_t> histogram; ///< histogram[d] is the number of SCCs with alternation depth d.
+
+  alternation_depth_statistics_t()
+    : depth(0)
+  {}
+};
 
-template<typename ComponentMap, typename NestingMap>
+namespace detail
+{
+
+/* \brief Set rank[v] to the position of the priority of v among the
+ *        distinct priorities of g.
+ *
+ * Takes linear time if the priorities are at most twice the number of
+ * vertices, which is the common case.
+ * \return the number of distinct priorities.
+ */
+template <typename Graph>
 inline
-void
-nesting_depth(const parity_game_t& g, ComponentMap cm, NestingMap nm)
+size_t dense_priority_ranks(const Graph& g, std::vector<size_t>& rank)
 {
-  cpplog(cpplogging::debug) << "Computing nesting depth" << std::endl;
-  typename boost::graph_traits<parity_game_t>::vertex_iterator i,end;
-  for(boost::tie(i, end) = boost::vertices(g); i != end; ++i)
+  const size_t n = boost::num_vertices(g);
+  rank.resize(n);
+  priority_t max_priority = 0;
+  for(size_t v = 0; v < n; ++v)
+    max_priority = std::max(max_priority, g[v].prio);
+
+  if(max_priority > 2*n)
   {
-    nm[*i] = 1;
-    typename boost::graph_traits<parity_game_t>::in_edge_iterator ai,aend;
-    for(boost::tie(ai, aend) = boost::in_edges(*i,g); ai != aend; ++ai)
-    {
-      if(cm[boost::source(*ai,g)] != cm[*i] || boost::source(*ai,g) >= *i)
-        continue;
+    const std::vector<priority_t> priorities = distinct_priorities(g);
+    rank = priority_ranks(g, priorities);
+    return priorities.size();
+  }
 
-      if((g[*i].prio % 2) == (g[boost::source(*ai,g)].prio % 2))
-        nm[*i] = std::max(nm[*i], nm[boost::source(*ai,g)]);
-      else
-        nm[*i] = std::max(nm[*i], 1+nm[boost::source(*ai,g)]);
-    }
+  std::vector<size_t> position(max_priority + 1, 0);
+  for(size_t v = 0; v < n; ++v)
+    position[g[v].prio] = 1;
+  size_t distinct = 0;
+  for(size_t p = 0; p <= max_priority; ++p)
+  {
+    const size_t present = position[p];
+    position[p] = distinct;
+    distinct += present;
   }
+  for(size_t v = 0; v < n; ++v)
+    rank[v] = position[g[v].prio];
+  return distinct;
 }
 
-template<typename ComponentMap, typename NestingMap>
+/* \brief Stable counting sort of order by key.
+ * \return first, with first[k] the position of the first element with key k,
+ *         and first[keys] == order.size().
+ */
 inline
-void
-nesting_depth_priority_sorting(const parity_game_t& g, ComponentMap cm, NestingMap nm)
+std::vector<size_t> counting_sort(std::vector<size_t>& order, const std::vector<size_t>& key, size_t keys)
 {
-  cpplog(cpplogging::debug) << "Computing nesting depth using priority sorting" << std::endl;
-  typedef typename boost::graph_traits<parity_game_t>::vertices_size_type vertex_size_t;
-  typedef typename boost::graph_traits<parity_game_t>::vertex_descriptor vertex_t;
+  std::vector<size_t> first(keys + 1, 0);
+  for(size_t v: order)
+    ++first[key[v] + 1];
+  for(size_t k = 0; k < keys; ++k)
+    first[k + 1] += first[k];
+  std::vector<size_t> next(first.begin(), first.end() - 1);
+  std::vector<size_t> sorted(order.size());
+  for(size_t v: order)
+    sorted[next[key[v]]++] = v;
+  order.swap(sorted);
+  return first;
+}
+
+} // namespace detail
+
+/* \brief Alternation depth of every SCC of g, given its SCCs.
+ *
+ * Within an SCC, the nesting depth of a vertex is determined by its
+ * predecessors in the same SCC that come earlier in the given ordering; edges
+ * between SCCs are ignored, so the SCCs are processed independently, in
+ * parallel. The vertices of each SCC are visited in the required order after
+ * bucketing them by (dense) priority and by component, in linear time.
+ *
+ * \param bwd the predecessors of every vertex of g.
+ * \param component the SCC of every vertex, numbered 0 to sccs-1.
+ */
+template <typename Graph>
+inline
+alternation_depth_statistics_t alternation_depth_statistics(const Graph& g, const csr_graph& bwd,
+    const std::vector<size_t>& component, size_t sccs, alternation_depth_ordering ordering)
+{
+  cpplog(cpplogging::debug) << "Computing nesting depth per SCC" << std::endl;
+  const size_t n = boost::num_vertices(g);
+  alternation_depth_statistics_t result;
+  if(n == 0)
+    return result;
+
+  std::vector<size_t> order(n);
+  for(size_t v = 0; v < n; ++v)
+    order[v] = v;
+  std::vector<size_t> rank;
+  if(ordering == priority_ordering)
+  {
+    const size_t priorities = detail::dense_priority_ranks(g, rank);
+    detail::counting_sort(order, rank, priorities);
+  }
+  else
+  {
+    rank = order;
+  }
+  const std::vector<size_t> first = detail::counting_sort(order, component, sccs);
+
+  std::vector<size_t> nesting(n, 1);
+  std::vector<size_t> scc_depth(sccs, 1);
+  parallel_for(0, sccs, [&](size_t c, size_t)
+  {
+    size_t depth = 1;
+    for(size_t i = first[c]; i < first[c + 1]; ++i)
+    {
+      const size_t v = order[i];
+      size_t& nv = nesting[v];
+      for(const csr_vertex_t* u = bwd.begin(v); u != bwd.end(v); ++u)
+      {
+        if(component[*u] != c || rank[*u] >= rank[v])
+          continue;
+        nv = std::max(nv, nesting[*u] + (g[v].prio % 2 != g[*u].prio % 2));
+      }
+      depth = std::max(depth, nv);
+    }
+    scc_depth[c] = depth;
+  }, 64);
+
+  result.depth = *std::max_element(scc_depth.begin(), scc_depth.end());
+  result.histogram.assign(result.depth + 1, 0);
+  for(size_t d: scc_depth)
+    ++result.histogram[d];
+  return result;
+}
+
+namespace detail
+{
+
+template <typename Graph>
+inline
+alternation_depth_statistics_t alternation_depth_statistics(const Graph& g, alternation_depth_ordering ordering)
+{
+  const csr_graph fwd = make_csr(g);
+  const csr_graph bwd = make_reverse_csr(fwd);
+  std::vector<size_t> components;
+  const size_t sccs = scc_decomposition(fwd, bwd, components);
+  return alternation_depth_statistics(g, bwd, components, sccs, ordering);
+}
+
+} // namespace detail
+
+namespace detail
+{
+
+/* \brief Computes the nested alternation depth from the hierarchy of SCCs
+ *        of the subgames with priorities up to each threshold.
+ *
+ * An edge (u, v) exists from threshold t(u, v) = max(rank(u), rank(v)) on,
+ * and its endpoints end up in the same SCC at some threshold of at least
+ * t(u, v). These merge thresholds are found offline for all edges at once
+ * by divide and conquer over the thresholds: for the thresholds in [l, r]
+ * with middle m, the edges that exist at m are searched for SCCs on the
+ * graph whose vertices are the SCCs merged so far (a union-find structure),
+ * and the edges are split into those that are merged by m and those that
+ * are not. Every edge takes part in O(log d) searches for d priorities.
+ *
+ * The merges are performed in order of increasing threshold. The SCC formed
+ * at threshold t has highest priority t, and the SCCs merged into it that
+ * were formed earlier are exactly its nested SCCs after removing the
+ * vertices with priority t.
+ */
+class nested_alternation_depth_engine
+{
+protected:
+  struct edge
+  {
+    csr_vertex_t source;
+    csr_vertex_t target;
+    size_t threshold;
+  };
+
+  std::vector<edge> m_edges;
+  std::vector<char> m_odd;          ///< parity of the priority of every rank
+  std::vector<size_t> m_parent;     ///< union-find forest over the vertices
+  std::vector<size_t> m_scc;        ///< SCC formed by a set, per union-find root, or scc_unassigned
+  std::vector<size_t> m_scc_rank;   ///< threshold at which each SCC was formed
+  std::vector<size_t> m_scc_depth;  ///< nested alternation depth of each SCC
+  std::vector<size_t> m_local;      ///< position of a root in the current search
+  std::vector<size_t> m_stamp;      ///< search in which m_local was set
+  size_t m_search;
 
-  std::vector<vertex_t> order;
-  order.reserve(boost::num_vertices(g));
+  size_t find(size_t v)
+  {
+    while(m_parent[v] != v)
+    {
+      m_parent[v] = m_parent[m_parent[v]];
+      v = m_parent[v];
+    }
+    return v;
+  }
 
-  typename boost::graph_traits<parity_game_t>::vertex_iterator i,end;
-  for(boost::tie(i, end) = boost::vertices(g); i != end; ++i)
-    order.push_back(*i);
-  assert(order.size() == boost::num_vertices(g));
+  /// \brief The SCC of root formed at threshold t, creating it if needed.
+  size_t scc_at(size_t root, size_t t)
+  {
+    const size_t previous = m_scc[root];
+    if(previous != scc_unassigned && m_scc_rank[previous] == t)
+      return previous;
+    const size_t result = m_scc_rank.size();
+    m_scc_rank.push_back(t);
+    m_scc_depth.push_back(1);
+    if(previous != scc_unassigned)
+      nest(previous, result);
+    m_scc[root] = result;
+    return result;
+  }
 
-  std::sort(order.begin(), order.end(), [&g](const vertex_t& x, const vertex_t& y){return g[boost::vertex(x, g)].prio < g[boost::vertex(y, g)].prio;});
+  /// \brief Record that inner is nested in outer.
+  void nest(size_t inner, size_t outer)
+  {
+    const size_t alternation = m_odd[m_scc_rank[inner]] != m_odd[m_scc_rank[outer]];
+    m_scc_depth[outer] = std::max(m_scc_depth[outer], m_scc_depth[inner] + alternation);
+  }
+
+  /// \brief Merge the endpoints of the edges in [first, last), whose merge
+  ///        threshold is t.
+  void merge(size_t first, size_t last, size_t t)
+  {
+    for(size_t i = first; i < last; ++i)
+    {
+      const size_t u = find(m_edges[i].source);
+      const size_t v = find(m_edges[i].target);
+      const size_t c = scc_at(u, t);
+      if(u == v)
+        continue;
+      const size_t d = m_scc[v];
+      if(d != scc_unassigned && m_scc_rank[d] == t)
+        m_scc_depth[c] = std::max(m_scc_depth[c], m_scc_depth[d]);
+      else if(d != scc_unassigned)
+        nest(d, c);
+      m_parent[v] = u;
+    }
+  }
 
-  for(auto i: order)
+  /* \brief Move the edges in [first, last) that exist at threshold m and
+   *        whose endpoints are in the same SCC at m to the front.
+   * \return the end of the moved edges.
+   */
+  size_t split(size_t first, size_t last, size_t m)
   {
-    nm[i] = 1;
-    typename boost::graph_traits<parity_game_t>::in_edge_iterator ai,aend;
-    for(boost::tie(ai, aend) = boost::in_edges(i,g); ai != aend; ++ai)
+    ++m_search;
+    std::vector<size_t> roots;
+    std::vector<std::pair<csr_vertex_t, csr_vertex_t> > local_edges;
+    for(size_t i = first; i < last; ++i)
     {
-      if(cm[boost::source(*ai,g)] != cm[i] || g[boost::source(*ai,g)].prio >= g[i].prio)
+      if(m_edges[i].threshold > m)
         continue;
+      size_t endpoints[2] = { find(m_edges[i].source), find(m_edges[i].target) };
+      if(endpoints[0] == endpoints[1])
+        continue;
+      for(size_t& v: endpoints)
+      {
+        if(m_stamp[v] != m_search)
+        {
+          m_stamp[v] = m_search;
+          m_local[v] = roots.size();
+          roots.push_back(v);
+        }
+        v = m_local[v];
+      }
+      local_edges.push_back(std::make_pair(static_cast<csr_vertex_t>(endpoints[0]), static_cast<csr_vertex_t>(endpoints[1])));
+    }
 
-      if((g[i].prio % 2) == (g[boost::source(*ai,g)].prio % 2))
-        nm[i] = std::max(nm[i], nm[boost::source(*ai,g)]);
-      else
-        nm[i] = std::max(nm[i], 1+nm[boost::source(*ai,g)]);
+    std::sort(local_edges.begin(), local_edges.end());
+    local_edges.erase(std::unique(local_edges.begin(), local_edges.end()), local_edges.end());
+    std::vector<size_t> offsets(roots.size() + 1, 0);
+    std::vector<csr_vertex_t> targets;
+    targets.reserve(local_edges.size());
+    for(const std::pair<csr_vertex_t, csr_vertex_t>& e: local_edges)
+    {
+      ++offsets[e.first + 1];
+      targets.push_back(e.second);
     }
+    for(size_t v = 0; v < roots.size(); ++v)
+      offsets[v + 1] += offsets[v];
+    const csr_graph local(std::move(offsets), std::move(targets));
+    std::vector<size_t> component(roots.size(), scc_unassigned);
+    scc_state state(local, local, component);
+    scc_tarjan(state);
+
+    edge* middle = std::partition(m_edges.data() + first, m_edges.data() + last, [&](const edge& e)
+    {
+      if(e.threshold > m)
+        return false;
+      const size_t u = find(e.source);
+      const size_t v = find(e.target);
+      return u == v || component[m_local[u]] == component[m_local[v]];
+    });
+    return middle - m_edges.data();
   }
-}
 
+  /// \brief Merge the edges in [first, last), whose merge thresholds are in
+  ///        [l, r]; threshold r may also mean that they are never merged.
+  void solve(size_t first, size_t last, size_t l, size_t r, size_t never)
+  {
+    if(first == last)
+      return;
+    if(l == r)
+    {
+      if(l != never)
+        merge(first, last, l);
+      return;
+    }
+    const size_t m = l + (r - l)/2;
+    const size_t middle = split(first, last, m);
+    solve(first, middle, l, m, never);
+    solve(middle, last, m + 1, r, never);
+  }
+
+public:
+  template <typename Graph>
+  nested_alternation_depth_engine(const Graph& g, const csr_graph& fwd)
+    : m_parent(fwd.num_vertices()), m_scc(fwd.num_vertices(), scc_unassigned),
+      m_local(fwd.num_vertices(), 0), m_stamp(fwd.num_vertices(), 0), m_search(0)
+  {
+    std::vector<size_t> rank;
+    const size_t priorities = dense_priority_ranks(g, rank);
+    m_odd.resize(priorities);
+    for(size_t v = 0; v < fwd.num_vertices(); ++v)
+    {
+      m_odd[rank[v]] = g[v].prio % 2;
+      m_parent[v] = v;
+    }
+    m_edges.reserve(fwd.num_edges());
+    for(size_t v = 0; v < fwd.num_vertices(); ++v)
+    {
+      for(const csr_vertex_t* w = fwd.begin(v); w != fwd.end(v); ++w)
+      {
+        edge e = { static_cast<csr_vertex_t>(v), *w, std::max(rank[v], rank[*w]) };
+        m_edges.push_back(e);
+      }
+    }
+    solve(0, m_edges.size(), 0, priorities, priorities);
+  }
+
+  /// \brief Maximal nested alternation depth of an SCC; 0 if there are no
+  ///        cycles.
+  size_t depth() const
+  {
+    return m_scc_depth.empty() ? 0 : *std::max_element(m_scc_depth.begin(), m_scc_depth.end());
+  }
+};
+
+} // namespace detail
+
+/* \brief Nested alternation depth of g.
+ *
+ * The depth of an SCC with highest priority p is 1 plus the maximal number
+ * of alternations of parity along a chain of SCCs, each nested in the
+ * previous one after removing its vertices of highest priority. SCCs
+ * without cycles do not count, so the result is 0 for an acyclic graph.
+ */
+template <typename Graph>
+inline
+size_t nested_alternation_depth(const Graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing nested alternation depth" << std::endl;
+  const csr_graph fwd = make_csr(g);
+  return detail::nested_alternation_depth_engine(g, fwd).depth();
+}
 
 inline
 typename boost::graph_traits<parity_game_t>::vertices_size_type
 alternation_depth(const parity_game_t& g)
 {
   cpplog(cpplogging::verbose) << "Computing alternation depth" << std::endl;
-  typedef typename boost::graph_traits<parity_game_t>::vertices_size_type vertex_size_t;
-  std::vector<vertex_size_t> components (boost::num_vertices(g), 0);
-  boost::strong_components(g, &components[0]);
-
-  std::vector<vertex_size_t> nesting_depths(boost::num_vertices(g), 1);
-  nesting_depth(g, components, &nesting_depths[0]);
-
-  return *std::max_element(nesting_depths.begin(), nesting_depths.end());
+  return detail::alternation_depth_statistics(g, vertex_index_ordering).depth;
 }
 
 inline
@@ -104,14 +425,7 @@ typename boost::graph_traits<parity_game_t>::vertices_size_type
 alternation_depth_priority_sorting(const parity_game_t& g)
 {
   cpplog(cpplogging::verbose) << "Computing alternation depth with priority sorting" << std::endl;
-  typedef typename boost::graph_traits<parity_game_t>::vertices_size_type vertex_size_t;
-  std::vector<vertex_size_t> components (boost::num_vertices(g), 0);
-  boost::strong_components(g, &components[0]);
-
-  std::vector<vertex_size_t> nesting_depths(boost::num_vertices(g), 1);
-  nesting_depth_priority_sorting(g, components, &nesting_depths[0]);
-
-  return *std::max_element(nesting_depths.begin(), nesting_depths.end());
+  return detail::alternation_depth_statistics(g, priority_ordering).depth;
 }
 
 #endif // ALTERNATION_DEPTH_H
@@ -0,0 +1,110 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file anytime.h
+/// \brief Anytime upper bounds by randomized restarts of an elimination
+///        heuristic.
+///
+/// Every restart is identified by a seed, and computes an elimination
+/// ordering and its width. Restarts run in parallel until the budget runs
+/// out; the best ordering is kept, so stopping at any time gives a valid
+/// bound.
+
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "budget.h"
+#include "parallel.h"
+
+namespace detail
+{
+
+/// \brief The vertices [0, n), shuffled by random if it is given; used to
+///        break ties between vertices randomly.
+inline
+std::vector<size_t> tie_breaking_order(size_t n, std::mt19937* random)
+{
+  std::vector<size_t> result(n);
+  for(size_t v = 0; v < n; ++v)
+    result[v] = v;
+  if(random)
+    std::shuffle(result.begin(), result.end(), *random);
+  return result;
+}
+
+} // namespace detail
+
+struct anytime_upper_bound_t
+{
+  size_t width;                 ///< smallest width found
+  std::vector<size_t> ordering; ///< elimination ordering of that width
+  size_t restarts;              ///< number of restarts that completed
+  double time_to_best;          ///< seconds until the best width was found
+};
+
+/* \brief Run restart(seed, thread, ordering) for seeds 0, 1, 2, ... until b
+ *        is exhausted, and keep the ordering of minimal width.
+ *
+ * restart must append an elimination ordering to ordering, which is empty,
+ * and return its width; thread identifies the calling thread, so that
+ * restart can reuse per-thread state. Every restart consumes one step of b.
+ *
+ * If initial_ordering is not empty, it is an ordering of width
+ * initial_width, e.g. of the best heuristic, that the restarts have to
+ * beat. Otherwise the first restart always runs, so that there is a bound
+ * even if b is exhausted at the start.
+ */
+template <typename Restart>
+anytime_upper_bound_t anytime_upper_bound(Restart restart, budget& b,
+                                          size_t initial_width = std::numeric_limits<size_t>::max(),
+                                          const std::vector<size_t>& initial_ordering = std::vector<size_t>())
+{
+  anytime_upper_bound_t result;
+  result.width = initial_ordering.empty() ? std::numeric_limits<size_t>::max() : initial_width;
+  result.ordering = initial_ordering;
+  result.restarts = 0;
+  result.time_to_best = initial_ordering.empty() ? 0 : b.elapsed();
+  std::mutex result_mutex;
+  std::atomic<size_t> seed(0);
+
+  const auto run = [&](size_t thread, std::vector<size_t>& ordering)
+  {
+    ordering.clear();
+    const size_t width = restart(seed++, thread, ordering);
+    std::lock_guard<std::mutex> lock(result_mutex);
+    ++result.restarts;
+    if(width < result.width)
+    {
+      result.width = width;
+      result.ordering.swap(ordering);
+      result.time_to_best = b.elapsed();
+    }
+  };
+
+  if(initial_ordering.empty())
+  {
+    std::vector<size_t> ordering;
+    b.step();
+    run(0, ordering);
+  }
+  parallel_for(0, num_threads(), [&](size_t, size_t thread)
+  {
+    std::vector<size_t> ordering;
+    while(!b.exhausted() && b.step())
+      run(thread, ordering);
+  });
+  return result;
+}
+
+#endif // ANYTIME_H
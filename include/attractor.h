@@ -0,0 +1,258 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file attractor.h
+/// \brief Attractor computation on subgames, and measures derived from it.
+///
+/// The attractor of player alpha to a set of vertices U within a subgame is
+/// the set of vertices from which alpha can force a play to U. It is
+/// computed backwards from U: a vertex of alpha is attracted as soon as one
+/// of its successors is, a vertex of the opponent once all its successors in
+/// the subgame are. The latter is tracked with a counter of remaining
+/// successors per vertex, so every call takes time linear in the number of
+/// edges of the attractor.
+
+#ifndef ATTRACTOR_H
+#define ATTRACTOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "csr.h"
+#include "pg.h"
+
+/// \brief A set of vertices in [0, n), stored as a bitset.
+class vertex_set
+{
+protected:
+  size_t m_size;
+  std::vector<uint64_t> m_words;
+
+public:
+  vertex_set(size_t n = 0, bool full = false)
+    : m_size(n), m_words((n + 63)/64, full ? ~uint64_t(0) : 0)
+  {
+    if(full && n % 64 != 0)
+      m_words.back() = (uint64_t(1) << (n % 64)) - 1;
+  }
+
+  /// \brief Size of the universe.
+  size_t universe() const
+  {
+    return m_size;
+  }
+
+  bool contains(size_t v) const
+  {
+    return (m_words[v/64] >> (v % 64)) & 1;
+  }
+
+  void insert(size_t v)
+  {
+    m_words[v/64] |= uint64_t(1) << (v % 64);
+  }
+
+  void erase(size_t v)
+  {
+    m_words[v/64] &= ~(uint64_t(1) << (v % 64));
+  }
+
+  /// \brief Number of elements.
+  size_t count() const
+  {
+    size_t result = 0;
+    for(uint64_t w: m_words)
+      result += __builtin_popcountll(w);
+    return result;
+  }
+
+  bool empty() const
+  {
+    return std::all_of(m_words.begin(), m_words.end(), [](uint64_t w) { return w == 0; });
+  }
+
+  /// \brief Remove all elements, keeping the universe.
+  void clear()
+  {
+    std::fill(m_words.begin(), m_words.end(), 0);
+  }
+
+  /// \brief Remove all elements of other.
+  void subtract(const vertex_set& other)
+  {
+    for(size_t i = 0; i < m_words.size(); ++i)
+      m_words[i] &= ~other.m_words[i];
+  }
+
+  /// \brief Call f(v) for all elements v, in increasing order.
+  template <typename Function>
+  void for_each(Function f) const
+  {
+    for(size_t i = 0; i < m_words.size(); ++i)
+    {
+      uint64_t w = m_words[i];
+      while(w != 0)
+      {
+        f(i*64 + __builtin_ctzll(w));
+        w &= w - 1;
+      }
+    }
+  }
+};
+
+/* \brief Computes attractors in subgames of a fixed game.
+ *
+ * All buffers are allocated once, in the constructor; the counters of
+ * remaining successors are initialised lazily per call, for the vertices
+ * that are actually reached, using an epoch stamp.
+ */
+class attractor_engine
+{
+protected:
+  const csr_graph& m_fwd;
+  const csr_graph& m_bwd;
+  std::vector<player_t> m_owner;
+  std::vector<uint32_t> m_remaining; ///< successors in the subgame not yet attracted
+  std::vector<uint32_t> m_stamp;     ///< epoch in which m_remaining was initialised
+  uint32_t m_epoch;
+  std::vector<csr_vertex_t> m_queue;
+  size_t m_calls;
+
+public:
+  template <typename Graph>
+  attractor_engine(const Graph& g, const csr_graph& fwd, const csr_graph& bwd)
+    : m_fwd(fwd), m_bwd(bwd), m_owner(fwd.num_vertices()),
+      m_remaining(fwd.num_vertices(), 0), m_stamp(fwd.num_vertices(), 0), m_epoch(0), m_calls(0)
+  {
+    for(size_t v = 0; v < m_owner.size(); ++v)
+      m_owner[v] = g[v].player;
+    m_queue.reserve(fwd.num_vertices());
+  }
+
+  player_t owner(size_t v) const
+  {
+    return m_owner[v];
+  }
+
+  /// \brief Number of attractors computed so far.
+  size_t calls() const
+  {
+    return m_calls;
+  }
+
+  /* \brief Extend target, a subset of subgame, to the attractor of alpha
+   *        to target within subgame.
+   *
+   * Vertices of the opponent without successors in subgame are not
+   * attracted; this only matters if subgame is not total, which never
+   * happens for subgames obtained by removing attractors from a total game.
+   *
+   * \return the number of layers that were added; layer i consists of the
+   *         vertices that alpha can force to target in i steps, but not in
+   *         fewer.
+   */
+  size_t attract(const vertex_set& subgame, vertex_set& target, player_t alpha)
+  {
+    ++m_calls;
+    if(++m_epoch == 0)
+    {
+      std::fill(m_stamp.begin(), m_stamp.end(), 0);
+      m_epoch = 1;
+    }
+    m_queue.clear();
+    target.for_each([&](size_t v) { m_queue.push_back(static_cast<csr_vertex_t>(v)); });
+
+    size_t depth = 0;
+    size_t level_begin = 0;
+    while(level_begin < m_queue.size())
+    {
+      const size_t level_end = m_queue.size();
+      for(size_t i = level_begin; i < level_end; ++i)
+      {
+        const csr_vertex_t v = m_queue[i];
+        for(const csr_vertex_t* u = m_bwd.begin(v); u != m_bwd.end(v); ++u)
+        {
+          if(!subgame.contains(*u) || target.contains(*u))
+            continue;
+          if(m_owner[*u] != alpha)
+          {
+            if(m_stamp[*u] != m_epoch)
+            {
+              m_stamp[*u] = m_epoch;
+              m_remaining[*u] = 0;
+              for(const csr_vertex_t* w = m_fwd.begin(*u); w != m_fwd.end(*u); ++w)
+                m_remaining[*u] += subgame.contains(*w);
+            }
+            if(--m_remaining[*u] != 0)
+              continue;
+          }
+          target.insert(*u);
+          m_queue.push_back(*u);
+        }
+      }
+      if(level_end < m_queue.size())
+        ++depth;
+      level_begin = level_end;
+    }
+    return depth;
+  }
+};
+
+struct attractor_statistics_t
+{
+  priority_t top_priority; ///< Highest priority of the player's parity.
+  size_t size;             ///< Size of the player's attractor to the vertices with top_priority.
+  size_t depth;            ///< Number of layers of that attractor.
+  bool exists;             ///< Whether the game contains a priority of the player's parity.
+
+  attractor_statistics_t()
+    : top_priority(0), size(0), depth(0), exists(false)
+  {}
+};
+
+/// \brief For both players, the attractor to the vertices with the highest
+///        priority of that player's parity.
+template <typename Graph>
+inline
+std::vector<attractor_statistics_t> top_priority_attractors(const Graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing attractors of top priorities" << std::endl;
+  const csr_graph fwd = make_csr(g);
+  const csr_graph bwd = make_reverse_csr(fwd);
+  const size_t n = fwd.num_vertices();
+  attractor_engine engine(g, fwd, bwd);
+  const vertex_set game(n, true);
+
+  std::vector<attractor_statistics_t> result(2);
+  for(size_t v = 0; v < n; ++v)
+  {
+    attractor_statistics_t& r = result[g[v].prio % 2];
+    if(!r.exists || g[v].prio > r.top_priority)
+      r.top_priority = g[v].prio;
+    r.exists = true;
+  }
+
+  for(size_t alpha = 0; alpha < 2; ++alpha)
+  {
+    attractor_statistics_t& r = result[alpha];
+    if(!r.exists)
+      continue;
+    vertex_set target(n);
+    for(size_t v = 0; v < n; ++v)
+    {
+      if(g[v].prio == r.top_priority)
+        target.insert(v);
+    }
+    r.depth = engine.attract(game, target, static_cast<player_t>(alpha));
+    r.size = target.count();
+  }
+  return result;
+}
+
+#endif // ATTRACTOR_H
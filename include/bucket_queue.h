@@ -0,0 +1,164 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file bucket_queue.h
+/// \brief Priority queue for vertices with small integer keys, such as
+///        degrees.
+///
+/// Every key has a bucket holding a doubly linked list of vertices, so
+/// insertion, removal and changing a key take constant time. The minimal key
+/// is tracked lazily: it only moves up when the bucket it points to runs
+/// empty, so finding the minimum takes amortised constant time as long as
+/// keys change by small amounts, as degrees do during elimination.
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+class bucket_queue
+{
+protected:
+  static size_t none()
+  {
+    return std::numeric_limits<size_t>::max();
+  }
+
+  std::vector<size_t> m_head; ///< first vertex in the bucket of every key
+  std::vector<size_t> m_next;
+  std::vector<size_t> m_prev;
+  std::vector<size_t> m_key;  ///< key of every vertex, or none() if absent
+  size_t m_min;               ///< no bucket below m_min is occupied
+  size_t m_max;               ///< no bucket above m_max is occupied
+  size_t m_size;
+
+public:
+  /// \brief Empty queue for vertices in [0, n) with keys in [0, max_key].
+  bucket_queue(size_t n, size_t max_key)
+    : m_head(max_key + 1, none()), m_next(n, none()), m_prev(n, none()), m_key(n, none()),
+      m_min(max_key + 1), m_max(0), m_size(0)
+  {}
+
+  size_t size() const
+  {
+    return m_size;
+  }
+
+  bool empty() const
+  {
+    return m_size == 0;
+  }
+
+  bool contains(size_t v) const
+  {
+    return m_key[v] != none();
+  }
+
+  size_t key(size_t v) const
+  {
+    return m_key[v];
+  }
+
+  /// \pre !contains(v) and key is at most the maximal key.
+  void push(size_t v, size_t key)
+  {
+    assert(!contains(v) && key < m_head.size());
+    m_key[v] = key;
+    m_prev[v] = none();
+    m_next[v] = m_head[key];
+    if(m_head[key] != none())
+      m_prev[m_head[key]] = v;
+    m_head[key] = v;
+    m_min = std::min(m_min, key);
+    m_max = std::max(m_max, key);
+    ++m_size;
+  }
+
+  /// \pre contains(v)
+  void erase(size_t v)
+  {
+    assert(contains(v));
+    if(m_prev[v] != none())
+      m_next[m_prev[v]] = m_next[v];
+    else
+      m_head[m_key[v]] = m_next[v];
+    if(m_next[v] != none())
+      m_prev[m_next[v]] = m_prev[v];
+    m_key[v] = none();
+    --m_size;
+  }
+
+  /// \brief Change the key of v; v keeps its place if the key is unchanged.
+  void update(size_t v, size_t key)
+  {
+    if(m_key[v] == key)
+      return;
+    erase(v);
+    push(v, key);
+  }
+
+  /// \brief Minimal key in the queue.
+  /// \pre !empty()
+  size_t min_key()
+  {
+    assert(!empty());
+    while(m_head[m_min] == none())
+      ++m_min;
+    return m_min;
+  }
+
+  /// \brief Maximal key in the queue.
+  /// \pre !empty()
+  size_t max_key()
+  {
+    assert(!empty());
+    while(m_head[m_max] == none())
+      --m_max;
+    return m_max;
+  }
+
+  /// \brief Vertex with minimal key; among those, the one that was pushed
+  ///        last.
+  /// \pre !empty()
+  size_t top()
+  {
+    return m_head[min_key()];
+  }
+
+  /// \brief Remove and return top().
+  size_t pop()
+  {
+    const size_t result = top();
+    erase(result);
+    return result;
+  }
+
+  /// \brief Remove and return a vertex with maximal key; among those, the
+  ///        one that was pushed last.
+  /// \pre !empty()
+  size_t pop_max()
+  {
+    const size_t result = m_head[max_key()];
+    erase(result);
+    return result;
+  }
+
+  /// \brief Call f(v) for all vertices v with the given key; f must not
+  ///        change the queue.
+  template <typename Function>
+  void for_each(size_t key, Function f) const
+  {
+    for(size_t v = m_head[key]; v != none(); v = m_next[v])
+      f(v);
+  }
+};
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,82 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file budget.h
+/// \brief Limits on the work done by a single expensive measure.
+///
+/// A budget consists of a wall-clock time limit and a limit on the number of
+/// steps, where the meaning of a step is up to the measure. Measures that
+/// run out of budget stop early and report partial results.
+
+#ifndef BUDGET_H
+#define BUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+class budget
+{
+protected:
+  typedef std::chrono::steady_clock clock;
+
+  clock::time_point m_start;
+  double m_seconds;
+  size_t m_max_steps;
+  std::atomic<size_t> m_steps;
+  std::atomic<bool> m_exhausted;
+
+public:
+  /// \brief A budget of at most seconds (0 means unlimited) and max_steps
+  ///        steps.
+  budget(double seconds = 0, size_t max_steps = std::numeric_limits<size_t>::max())
+    : m_start(clock::now()), m_seconds(seconds), m_max_steps(max_steps), m_steps(0), m_exhausted(false)
+  {}
+
+  /// \brief Seconds since the budget was created.
+  double elapsed() const
+  {
+    return std::chrono::duration<double>(clock::now() - m_start).count();
+  }
+
+  size_t steps() const
+  {
+    return m_steps.load();
+  }
+
+  /// \brief Consume one step; the clock is read on every step, since steps
+  ///        are substantial units of work, such as a recursive call.
+  /// \return whether the budget allowed the step.
+  bool step()
+  {
+    if(m_exhausted.load(std::memory_order_relaxed))
+      return false;
+    const size_t n = ++m_steps;
+    if(n > m_max_steps || (m_seconds > 0 && elapsed() > m_seconds))
+    {
+      m_exhausted.store(true);
+      return false;
+    }
+    return true;
+  }
+
+  /// \brief Whether the budget ran out, or was cancelled.
+  bool exhausted() const
+  {
+    return m_exhausted.load(std::memory_order_relaxed)
+        || (m_seconds > 0 && elapsed() > m_seconds);
+  }
+
+  /// \brief Stop all work charged to this budget.
+  void cancel()
+  {
+    m_exhausted.store(true);
+  }
+};
+
+#endif // BUDGET_H
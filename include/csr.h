@@ -0,0 +1,133 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file csr.h
+/// \brief Frozen graph in compressed sparse row format.
+///
+/// The boost adjacency lists store successors in red-black trees. Measures
+/// that repeatedly scan or intersect adjacency lists instead work on a
+/// frozen copy of the graph, in which the successors of every vertex are
+/// stored contiguously and in increasing order.
+
+#ifndef CSR_H
+#define CSR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <boost/graph/graph_traits.hpp>
+
+/// \brief Vertex type used in frozen graphs.
+typedef uint32_t csr_vertex_t;
+
+class csr_graph
+{
+protected:
+  std::vector<size_t> m_offsets; ///< Successors of v are at [m_offsets[v], m_offsets[v+1]).
+  std::vector<csr_vertex_t> m_targets;
+
+public:
+  csr_graph()
+    : m_offsets(1, 0)
+  {}
+
+  /// \brief Construct from explicit offsets and targets.
+  /// \pre every range of targets is sorted and free of duplicates.
+  csr_graph(std::vector<size_t>&& offsets, std::vector<csr_vertex_t>&& targets)
+    : m_offsets(std::move(offsets)), m_targets(std::move(targets))
+  {}
+
+  size_t num_vertices() const
+  {
+    return m_offsets.size() - 1;
+  }
+
+  size_t num_edges() const
+  {
+    return m_targets.size();
+  }
+
+  size_t degree(size_t v) const
+  {
+    return m_offsets[v+1] - m_offsets[v];
+  }
+
+  const csr_vertex_t* begin(size_t v) const
+  {
+    return m_targets.data() + m_offsets[v];
+  }
+
+  const csr_vertex_t* end(size_t v) const
+  {
+    return m_targets.data() + m_offsets[v+1];
+  }
+
+  bool has_edge(size_t u, size_t v) const
+  {
+    return std::binary_search(begin(u), end(u), static_cast<csr_vertex_t>(v));
+  }
+
+  const std::vector<size_t>& offsets() const
+  {
+    return m_offsets;
+  }
+
+  const std::vector<csr_vertex_t>& targets() const
+  {
+    return m_targets;
+  }
+};
+
+/// \brief Freeze the out-adjacency of g; successors are sorted.
+template <typename Graph>
+inline
+csr_graph make_csr(const Graph& g)
+{
+  const size_t n = boost::num_vertices(g);
+  std::vector<size_t> offsets(n + 1, 0);
+  std::vector<csr_vertex_t> targets;
+
+  typename boost::graph_traits<Graph>::vertex_iterator i, end;
+  typename boost::graph_traits<Graph>::adjacency_iterator ai, aend;
+  for(boost::tie(i, end) = boost::vertices(g); i != end; ++i)
+  {
+    const size_t first = targets.size();
+    for(boost::tie(ai, aend) = boost::adjacent_vertices(*i, g); ai != aend; ++ai)
+      targets.push_back(static_cast<csr_vertex_t>(*ai));
+    // setS adjacency lists are already sorted, other selectors need not be.
+    if(!std::is_sorted(targets.begin() + first, targets.end()))
+      std::sort(targets.begin() + first, targets.end());
+    targets.erase(std::unique(targets.begin() + first, targets.end()), targets.end());
+    offsets[*i + 1] = targets.size();
+  }
+  return csr_graph(std::move(offsets), std::move(targets));
+}
+
+/// \brief The graph with all edges of c reversed; predecessors are sorted.
+inline
+csr_graph make_reverse_csr(const csr_graph& c)
+{
+  const size_t n = c.num_vertices();
+  std::vector<size_t> offsets(n + 1, 0);
+  for(csr_vertex_t w: c.targets())
+    ++offsets[w + 1];
+  for(size_t v = 0; v < n; ++v)
+    offsets[v + 1] += offsets[v];
+
+  // Sources are visited in increasing order, so every list ends up sorted.
+  std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+  std::vector<csr_vertex_t> targets(c.num_edges());
+  for(size_t v = 0; v < n; ++v)
+  {
+    for(const csr_vertex_t* w = c.begin(v); w != c.end(v); ++w)
+      targets[position[*w]++] = static_cast<csr_vertex_t>(v);
+  }
+  return csr_graph(std::move(offsets), std::move(targets));
+}
+
+#endif // CSR_H
@@ -14,21 +14,18 @@
 
 #include "cpplogging/logger.h"
 #include "pg.h"
-#include "bfs.h"
+#include "sweep.h"
 
+/// \brief The maximal distance from a vertex to a vertex reachable from it.
 template<typename Graph>
 inline
 typename boost::graph_traits<Graph>::vertices_size_type
 diameter(const Graph& g)
 {
   cpplog(cpplogging::verbose) << "Computing diameter" << std::endl;
-  typename boost::graph_traits<Graph>::vertices_size_type result = 0;
-  typename boost::graph_traits<Graph>::vertex_iterator i, end;
-  for (boost::tie(i, end) = vertices(g); i != end; ++i)
-  {
-    result = std::max(result, bfs_levels(g, *i) - 1);
-  }
-  return result;
+  sweep_options options;
+  options.diameter = true;
+  return all_sources_sweep(g, options).diameter;
 }
 
 #endif // DIAMETER_H
@@ -12,7 +12,14 @@
 #ifndef DIAMOND_H
 #define DIAMOND_H
 
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include "cpplogging/logger.h"
+#include "csr.h"
+#include "parallel.h"
+#include "pg.h"
+#include "simd.h"
 
 struct diamond_count_t
 {
@@ -25,81 +32,160 @@ struct diamond_count_t
   {}
 };
 
-// Count the number of 2-diamonds in the graph.
-template <typename Graph>
-diamond_count_t diamond_count(const Graph& g)
+namespace detail
 {
-  cpplog(cpplogging::verbose) << "Counting number of 2-diamonds in the graph" << std::endl;
-  diamond_count_t result;
-
-  typename boost::graph_traits< Graph >::vertex_iterator i, end;
-  typename boost::graph_traits< Graph >::adjacency_iterator ai,aj,aend;
 
-  for (boost::tie(i, end) = boost::vertices(g); i != end; ++i)
+/* \brief Count the 2-diamonds with top vertex u whose first successor v is
+ *        at a position in [row_first, row_last) of the successors of u.
+ *
+ * A 2-diamond consists of u, two distinct successors v < w of u, and a common
+ * successor of v and w. Diamonds are even (odd) if u, v and w are all owned
+ * by player even (odd).
+ */
+inline
+void diamond_count(const csr_graph& g, const std::vector<player_t>& owner, size_t u,
+                   size_t row_first, size_t row_last, diamond_count_t& result)
+{
+  const csr_vertex_t* last = g.end(u);
+  const csr_vertex_t* vlast = g.begin(u) + std::min(row_last, g.degree(u));
+  for(const csr_vertex_t* vi = g.begin(u) + row_first; vi < vlast; ++vi)
   {
-    typename Graph::vertex_descriptor u = *i;
-    cpplog(cpplogging::debug) << "Vertex u = " << u << std::endl;
-
-    boost::tie(ai, aend) = boost::adjacent_vertices(u, g);
-    if (ai == aend)
+    const csr_vertex_t v = *vi;
+    for(const csr_vertex_t* wi = vi + 1; wi != last; ++wi)
     {
-      cpplog(cpplogging::debug) << "Vertex " << u << " has no successors" << std::endl;
-      continue;
-    }
+      const csr_vertex_t w = *wi;
+      const size_t n = intersection_size(g.begin(v), g.end(v), g.begin(w), g.end(w));
+      if(n == 0)
+        continue;
 
-    for(; ai != aend; ++ai)
-    {
+      result.all += n;
+      if(owner[u] == owner[v] && owner[v] == owner[w])
       {
-        typename boost::graph_traits< Graph >::adjacency_iterator ai_ = ai;
-        if(++ai_ == aend)
-        {
-          continue; // workaround to loop to aend - 1
-        }
+        if(owner[u] == even)
+          result.even += n;
+        else
+          result.odd += n;
       }
-      typename Graph::vertex_descriptor v = *ai;
+    }
+  }
+}
+
+/// \brief Unit of work for the parallel diamond count: the rows
+///        [row_first, row_last) of the successor pairs of all vertices in
+///        [u_first, u_last).
+struct diamond_task
+{
+  size_t u_first;
+  size_t u_last;
+  size_t row_first;
+  size_t row_last;
 
-      cpplog(cpplogging::debug) << "  Vertex v = " << v << std::endl;
+  diamond_task(size_t uf, size_t ul, size_t rf, size_t rl)
+    : u_first(uf), u_last(ul), row_first(rf), row_last(rl)
+  {}
+};
 
-      aj = ai;
-      ++aj;
-      if(aj == aend)
+/* \brief Split the successor pairs of all vertices into tasks of roughly
+ *        grain pairs each.
+ *
+ * The number of pairs of a vertex is quadratic in its out-degree. Runs of
+ * consecutive low-degree vertices are therefore grouped into a single task,
+ * whereas the pairs of a high-degree vertex are split by row (the position
+ * of v among the successors of u) into several tasks.
+ */
+inline
+std::vector<diamond_task> diamond_tasks(const csr_graph& g, size_t grain)
+{
+  std::vector<diamond_task> tasks;
+  const size_t n = g.num_vertices();
+  size_t u_first = 0;
+  size_t pairs = 0;
+  for(size_t u = 0; u < n; ++u)
+  {
+    const size_t d = g.degree(u);
+    const size_t pairs_u = d < 2 ? 0 : d*(d-1)/2;
+    if(pairs_u < grain)
+    {
+      pairs += pairs_u;
+      if(pairs >= grain)
       {
-        cpplog(cpplogging::debug) << "    w = v; skipping" << std::endl;
+        tasks.push_back(diamond_task(u_first, u+1, 0, std::numeric_limits<size_t>::max()));
+        u_first = u+1;
+        pairs = 0;
       }
+      continue;
+    }
 
-      for(; aj != aend; ++aj)
+    // Flush the pending low-degree vertices, and split u by rows; row i
+    // contains d-1-i pairs.
+    if(u_first < u)
+      tasks.push_back(diamond_task(u_first, u, 0, std::numeric_limits<size_t>::max()));
+    size_t row_first = 0;
+    size_t row_pairs = 0;
+    for(size_t row = 0; row + 1 < d; ++row)
+    {
+      row_pairs += d-1-row;
+      if(row_pairs >= grain)
       {
-        typename Graph::vertex_descriptor w = *aj;
-        cpplog(cpplogging::debug) << "      Checking diamond property for " << u << " with " << v << " and " << w << std::endl;
-
-        typename boost::graph_traits< Graph >::adjacency_iterator vi, wi, vend, wend;
-        boost::tie(vi, vend) = boost::adjacent_vertices(v, g);
-        boost::tie(wi, wend) = boost::adjacent_vertices(w, g);
-        while(vi != vend && wi != wend)
-        {
-          if(boost::vertex(*vi,g) < boost::vertex(*wi,g))
-            ++wi;
-          else if(boost::vertex(*wi, g) < boost::vertex(*vi, g))
-            ++vi;
-          else
-          {
-            cpplog(cpplogging::debug) << "      Diamond completed by " << *wi << std::endl;
-            ++result.all;
-            if(g[u].player == even && g[v].player == even && g[w].player == even)
-            {
-              ++result.even;
-            }
-            else if(g[u].player == odd && g[v].player == odd && g[w].player == odd)
-            {
-              ++result.odd;
-            }
-            ++vi; ++wi;
-          }
-        }
+        tasks.push_back(diamond_task(u, u+1, row_first, row+1));
+        row_first = row+1;
+        row_pairs = 0;
       }
-      cpplog(cpplogging::debug) << "      " << result.all << " diamonds after this iteration" << std::endl;
     }
+    if(row_pairs > 0)
+      tasks.push_back(diamond_task(u, u+1, row_first, d));
+    u_first = u+1;
+    pairs = 0;
+  }
+  if(u_first < n)
+    tasks.push_back(diamond_task(u_first, n, 0, std::numeric_limits<size_t>::max()));
+  return tasks;
+}
 
+/// \brief Thread-local counts, padded to avoid false sharing.
+struct padded_diamond_count
+{
+  diamond_count_t count;
+  char padding[64];
+};
+
+} // namespace detail
+
+/* \brief Count the number of 2-diamonds in the graph.
+ *
+ * The successor-pair space is split into tasks of similar size (see
+ * detail::diamond_tasks) that are distributed over the threads, so vertices
+ * with a very high out-degree do not serialise the computation.
+ */
+template <typename Graph>
+diamond_count_t diamond_count(const Graph& g)
+{
+  cpplog(cpplogging::verbose) << "Counting number of 2-diamonds in the graph" << std::endl;
+  const csr_graph c = make_csr(g);
+  std::vector<player_t> owner(boost::num_vertices(g));
+  for(size_t v = 0; v < owner.size(); ++v)
+    owner[v] = g[v].player;
+
+  size_t total_pairs = 0;
+  for(size_t u = 0; u < c.num_vertices(); ++u)
+    total_pairs += c.degree(u) < 2 ? 0 : c.degree(u)*(c.degree(u)-1)/2;
+  const size_t grain = std::max(size_t(1024), total_pairs/(64*num_threads()));
+  const std::vector<detail::diamond_task> tasks = detail::diamond_tasks(c, grain);
+
+  std::vector<detail::padded_diamond_count> counts(num_threads());
+  parallel_for(0, tasks.size(), [&](size_t i, size_t thread)
+  {
+    const detail::diamond_task& t = tasks[i];
+    for(size_t u = t.u_first; u < t.u_last; ++u)
+      detail::diamond_count(c, owner, u, t.row_first, t.row_last, counts[thread].count);
+  });
+
+  diamond_count_t result;
+  for(const detail::padded_diamond_count& local: counts)
+  {
+    result.all += local.count.all;
+    result.even += local.count.even;
+    result.odd += local.count.odd;
   }
   return result;
 }
@@ -0,0 +1,145 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file directed_elimination_graph.h
+/// \brief Simple directed graph that supports directed vertex elimination,
+///        as needed by Kelly-width heuristics.
+///
+/// Every vertex has sorted vectors of successors and predecessors, and a
+/// flag for a self-loop. Eliminating v adds u -> w for all u -> v -> w with
+/// u != w: the successors of v are merged into those of every predecessor,
+/// and the predecessors of v into those of every successor, so edges that
+/// already exist are neither added twice nor counted twice.
+
+#ifndef DIRECTED_ELIMINATION_GRAPH_H
+#define DIRECTED_ELIMINATION_GRAPH_H
+
+#include <algorithm>
+#include <vector>
+#include <boost/graph/graph_traits.hpp>
+#include "csr.h"
+#include "elimination_graph.h"
+
+class directed_elimination_graph
+{
+protected:
+  std::vector<std::vector<csr_vertex_t> > m_out;
+  std::vector<std::vector<csr_vertex_t> > m_in;
+  std::vector<char> m_selfloop;
+  std::vector<char> m_removed;
+  size_t m_vertices; ///< number of vertices that have not been removed
+  std::vector<csr_vertex_t> m_scratch;
+
+  void add_edge(size_t u, size_t v)
+  {
+    if(u == v)
+    {
+      m_selfloop[u] = 1;
+      return;
+    }
+    m_out[u].push_back(static_cast<csr_vertex_t>(v));
+    m_in[v].push_back(static_cast<csr_vertex_t>(u));
+  }
+
+public:
+  /// \brief The graph g; every edge of an undirected g is an edge in both
+  ///        directions.
+  template <typename Graph>
+  explicit directed_elimination_graph(const Graph& g)
+    : m_out(boost::num_vertices(g)), m_in(boost::num_vertices(g)), m_selfloop(boost::num_vertices(g), 0),
+      m_removed(boost::num_vertices(g), 0), m_vertices(boost::num_vertices(g))
+  {
+    const bool directed = boost::is_directed(g);
+    typename boost::graph_traits<Graph>::edge_iterator i, end;
+    for(boost::tie(i, end) = boost::edges(g); i != end; ++i)
+    {
+      const size_t u = boost::source(*i, g);
+      const size_t v = boost::target(*i, g);
+      add_edge(u, v);
+      if(!directed)
+        add_edge(v, u);
+    }
+    for(size_t v = 0; v < m_out.size(); ++v)
+    {
+      std::sort(m_out[v].begin(), m_out[v].end());
+      m_out[v].erase(std::unique(m_out[v].begin(), m_out[v].end()), m_out[v].end());
+      std::sort(m_in[v].begin(), m_in[v].end());
+      m_in[v].erase(std::unique(m_in[v].begin(), m_in[v].end()), m_in[v].end());
+    }
+  }
+
+  /// \brief Size of the range of vertex numbers, including removed vertices.
+  size_t universe() const
+  {
+    return m_out.size();
+  }
+
+  /// \brief Number of vertices that have not been removed.
+  size_t num_vertices() const
+  {
+    return m_vertices;
+  }
+
+  bool removed(size_t v) const
+  {
+    return m_removed[v];
+  }
+
+  /// \brief Number of successors of v, including v itself if v has a
+  ///        self-loop.
+  size_t out_degree(size_t v) const
+  {
+    return m_out[v].size() + m_selfloop[v];
+  }
+
+  /// \brief The successors of v other than v, in increasing order.
+  const std::vector<csr_vertex_t>& successors(size_t v) const
+  {
+    return m_out[v];
+  }
+
+  /// \brief The predecessors of v other than v, in increasing order.
+  const std::vector<csr_vertex_t>& predecessors(size_t v) const
+  {
+    return m_in[v];
+  }
+
+  bool has_edge(size_t u, size_t v) const
+  {
+    if(u == v)
+      return m_selfloop[u];
+    return std::binary_search(m_out[u].begin(), m_out[u].end(), static_cast<csr_vertex_t>(v));
+  }
+
+  /* \brief Eliminate v: add u -> w for all u -> v -> w with u != w, and
+   *        remove v.
+   *
+   * Calls changed(u) for every former predecessor u of v, since only their
+   * out-degrees change.
+   */
+  template <typename Function>
+  void eliminate(size_t v, Function changed)
+  {
+    std::vector<csr_vertex_t> successors;
+    std::vector<csr_vertex_t> predecessors;
+    successors.swap(m_out[v]);
+    predecessors.swap(m_in[v]);
+    m_selfloop[v] = 0;
+    m_removed[v] = 1;
+    --m_vertices;
+    for(csr_vertex_t w: successors)
+      detail::unite_sorted(m_in[w], predecessors, w, v, m_scratch, [](size_t) {});
+    for(csr_vertex_t u: predecessors)
+    {
+      detail::unite_sorted(m_out[u], successors, u, v, m_scratch, [](size_t) {});
+      changed(u);
+    }
+  }
+};
+
+#endif // DIRECTED_ELIMINATION_GRAPH_H
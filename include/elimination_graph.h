@@ -0,0 +1,290 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file elimination_graph.h
+/// \brief Simple undirected graph that supports vertex elimination and edge
+///        contraction, as needed by treewidth heuristics and bounds.
+///
+/// Every vertex has a sorted vector of neighbours. Eliminating a vertex v
+/// merges the neighbourhood of v into that of each of its neighbours, which
+/// takes time linear in the sizes of both, and avoids the per-edge
+/// allocations and lookups of a setS adjacency list.
+
+#ifndef ELIMINATION_GRAPH_H
+#define ELIMINATION_GRAPH_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <boost/graph/graph_traits.hpp>
+#include "csr.h"
+
+namespace detail
+{
+
+/// \brief Remove v from the sorted vector adjacent, if it is there.
+inline
+void erase_sorted(std::vector<csr_vertex_t>& adjacent, size_t v)
+{
+  std::vector<csr_vertex_t>::iterator i = std::lower_bound(adjacent.begin(), adjacent.end(), static_cast<csr_vertex_t>(v));
+  if(i != adjacent.end() && *i == v)
+    adjacent.erase(i);
+}
+
+/* \brief Set the sorted vector adjacent to (adjacent united with the sorted
+ *        vector neighbours) without u and v; scratch is used as a buffer.
+ *
+ * Calls added(w) for every w that was added to adjacent.
+ */
+template <typename Function>
+void unite_sorted(std::vector<csr_vertex_t>& adjacent, const std::vector<csr_vertex_t>& neighbours,
+                  size_t u, size_t v, std::vector<csr_vertex_t>& scratch, Function added)
+{
+  if(8*neighbours.size() < adjacent.size())
+  {
+    // Few additions to a long list, e.g. of a hub: insert them in place,
+    // which avoids copying the list into scratch. Every insertion and the
+    // erasures of u and v still shift the tail of the list, so this takes
+    // time linear in its length, and eliminating all rim vertices of a
+    // wheel remains quadratic; only the constant factor is smaller.
+    for(csr_vertex_t w: neighbours)
+    {
+      if(w == u || w == v)
+        continue;
+      std::vector<csr_vertex_t>::iterator i = std::lower_bound(adjacent.begin(), adjacent.end(), w);
+      if(i == adjacent.end() || *i != w)
+      {
+        adjacent.insert(i, w);
+        added(w);
+      }
+    }
+    erase_sorted(adjacent, u);
+    erase_sorted(adjacent, v);
+    return;
+  }
+  scratch.clear();
+  std::vector<csr_vertex_t>::const_iterator i = adjacent.begin(), j = neighbours.begin();
+  while(i != adjacent.end() || j != neighbours.end())
+  {
+    csr_vertex_t w;
+    if(j == neighbours.end() || (i != adjacent.end() && *i < *j))
+      w = *i++;
+    else if(i == adjacent.end() || *j < *i)
+    {
+      w = *j++;
+      if(w != u && w != v)
+        added(w);
+    }
+    else
+    {
+      w = *i++;
+      ++j;
+    }
+    if(w != u && w != v)
+      scratch.push_back(w);
+  }
+  adjacent.swap(scratch);
+}
+
+} // namespace detail
+
+class elimination_graph
+{
+protected:
+  std::vector<std::vector<csr_vertex_t> > m_adjacent;
+  std::vector<char> m_removed;
+  size_t m_vertices;   ///< number of vertices that have not been removed
+  size_t m_half_edges; ///< twice the number of edges
+  std::vector<csr_vertex_t> m_scratch;
+
+  /* \brief Set m_adjacent[u] to (m_adjacent[u] united with neighbours)
+   *        without u and v.
+   *
+   * Calls added(w) for every w that became a neighbour of u.
+   */
+  template <typename Function>
+  void unite(size_t u, const std::vector<csr_vertex_t>& neighbours, size_t v, Function added)
+  {
+    std::vector<csr_vertex_t>& adjacent = m_adjacent[u];
+    m_half_edges -= adjacent.size();
+    detail::unite_sorted(adjacent, neighbours, u, v, m_scratch, added);
+    m_half_edges += adjacent.size();
+  }
+
+  /// \brief Remove v from the neighbours of u.
+  void detach(size_t u, size_t v)
+  {
+    std::vector<csr_vertex_t>& adjacent = m_adjacent[u];
+    m_half_edges -= adjacent.size();
+    detail::erase_sorted(adjacent, v);
+    m_half_edges += adjacent.size();
+  }
+
+public:
+  /// \brief The undirected graph underlying g, without self-loops and
+  ///        parallel edges; g may be directed.
+  template <typename Graph>
+  explicit elimination_graph(const Graph& g)
+    : m_adjacent(boost::num_vertices(g)), m_removed(boost::num_vertices(g), 0),
+      m_vertices(boost::num_vertices(g)), m_half_edges(0)
+  {
+    typename boost::graph_traits<Graph>::edge_iterator i, end;
+    for(boost::tie(i, end) = boost::edges(g); i != end; ++i)
+    {
+      const size_t u = boost::source(*i, g);
+      const size_t v = boost::target(*i, g);
+      if(u == v)
+        continue;
+      m_adjacent[u].push_back(static_cast<csr_vertex_t>(v));
+      m_adjacent[v].push_back(static_cast<csr_vertex_t>(u));
+    }
+    for(std::vector<csr_vertex_t>& adjacent: m_adjacent)
+    {
+      std::sort(adjacent.begin(), adjacent.end());
+      adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+      m_half_edges += adjacent.size();
+    }
+  }
+
+  /// \brief The graph on vertices [0, n) with the given edges; edges may
+  ///        occur in both directions and more than once.
+  elimination_graph(size_t n, const std::vector<std::pair<csr_vertex_t, csr_vertex_t> >& edges)
+    : m_adjacent(n), m_removed(n, 0), m_vertices(n), m_half_edges(0)
+  {
+    for(const std::pair<csr_vertex_t, csr_vertex_t>& e: edges)
+    {
+      if(e.first == e.second)
+        continue;
+      m_adjacent[e.first].push_back(e.second);
+      m_adjacent[e.second].push_back(e.first);
+    }
+    for(std::vector<csr_vertex_t>& adjacent: m_adjacent)
+    {
+      std::sort(adjacent.begin(), adjacent.end());
+      adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+      m_half_edges += adjacent.size();
+    }
+  }
+
+  /// \brief Size of the range of vertex numbers, including removed vertices.
+  size_t universe() const
+  {
+    return m_adjacent.size();
+  }
+
+  /// \brief Number of vertices that have not been removed.
+  size_t num_vertices() const
+  {
+    return m_vertices;
+  }
+
+  size_t num_edges() const
+  {
+    return m_half_edges/2;
+  }
+
+  bool removed(size_t v) const
+  {
+    return m_removed[v];
+  }
+
+  size_t degree(size_t v) const
+  {
+    return m_adjacent[v].size();
+  }
+
+  /// \brief The neighbours of v, in increasing order.
+  const std::vector<csr_vertex_t>& neighbours(size_t v) const
+  {
+    return m_adjacent[v];
+  }
+
+  bool has_edge(size_t u, size_t v) const
+  {
+    return std::binary_search(m_adjacent[u].begin(), m_adjacent[u].end(), static_cast<csr_vertex_t>(v));
+  }
+
+  /* \brief Remove v and its edges.
+   *
+   * Calls changed(u) for every former neighbour u of v.
+   */
+  template <typename Function>
+  void remove(size_t v, Function changed)
+  {
+    std::vector<csr_vertex_t> neighbours;
+    neighbours.swap(m_adjacent[v]);
+    m_half_edges -= neighbours.size();
+    m_removed[v] = 1;
+    --m_vertices;
+    for(csr_vertex_t u: neighbours)
+    {
+      detach(u, v);
+      changed(u);
+    }
+  }
+
+  /* \brief Eliminate v: make its neighbours a clique, and remove v.
+   *
+   * Calls changed(u) for every former neighbour u of v, and added(u, w) with
+   * u < w for every edge u -- w that is added (the fill-in).
+   */
+  template <typename Changed, typename Added>
+  void eliminate(size_t v, Changed changed, Added added)
+  {
+    std::vector<csr_vertex_t> neighbours;
+    neighbours.swap(m_adjacent[v]);
+    m_half_edges -= neighbours.size();
+    m_removed[v] = 1;
+    --m_vertices;
+    for(csr_vertex_t u: neighbours)
+    {
+      unite(u, neighbours, v, [&](size_t w) { if(u < w) added(u, w); });
+      changed(u);
+    }
+  }
+
+  /// \brief Eliminate v, calling changed(u) for every former neighbour u.
+  template <typename Function>
+  void eliminate(size_t v, Function changed)
+  {
+    eliminate(v, changed, [](size_t, size_t) {});
+  }
+
+  /* \brief Contract the edge u -- v into u; v is removed.
+   *
+   * Calls changed(w) for u and every former neighbour w of v.
+   * \pre has_edge(u, v)
+   */
+  template <typename Function>
+  void contract(size_t u, size_t v, Function changed)
+  {
+    std::vector<csr_vertex_t> neighbours;
+    neighbours.swap(m_adjacent[v]);
+    m_half_edges -= neighbours.size();
+    m_removed[v] = 1;
+    --m_vertices;
+    unite(u, neighbours, v, [](size_t) {});
+    for(csr_vertex_t w: neighbours)
+    {
+      if(w == u)
+        continue;
+      // w loses v, and gains u unless it already was a neighbour of u.
+      std::vector<csr_vertex_t>& adjacent = m_adjacent[w];
+      adjacent.erase(std::lower_bound(adjacent.begin(), adjacent.end(), static_cast<csr_vertex_t>(v)));
+      std::vector<csr_vertex_t>::iterator i = std::lower_bound(adjacent.begin(), adjacent.end(), static_cast<csr_vertex_t>(u));
+      if(i == adjacent.end() || *i != u)
+        adjacent.insert(i, static_cast<csr_vertex_t>(u));
+      else
+        --m_half_edges;
+      changed(w);
+    }
+    changed(u);
+  }
+};
+
+#endif // ELIMINATION_GRAPH_H
@@ -12,79 +12,22 @@
 #ifndef GIRTH_H
 #define GIRTH_H
 
-#include <limits>
-#include <boost/graph/breadth_first_search.hpp>
 #include "cpplogging/logger.h"
-
-namespace detail
-{
-template<typename T>
-void update_girth(size_t& /*girth*/, ptrdiff_t /*x*/)
-{
-  // skip
-}
-
-template<>
-void update_girth<boost::on_black_target>(size_t& girth, ptrdiff_t x)
-{
-  assert(x >= 1);
-  girth = std::min(girth, static_cast<size_t>(x));
-}
-
-template<typename DistanceMap, class Tag>
-struct girth_recorder: public boost::default_bfs_visitor
-{
-  const DistanceMap& d;
-  size_t& girth;
-
-  girth_recorder(const DistanceMap& d_, size_t& girth_)
-    : d(d_), girth(girth_)
-  {}
-
-  typedef Tag event_filter;
-
-  template<typename Edge, typename Graph>
-  void operator()(Edge e, Graph& g)
-  {
-    typename Graph::vertex_descriptor u = boost::source(e,g), v = boost::target(e,g);
-
-    if(u == v)
-      girth = 1;
-    else
-      update_girth<Tag>(girth, d[u] - d[v] + 1);
-  }
-};
-
-template<typename DistanceMap, class Tag>
-girth_recorder<DistanceMap, Tag>
-record_girth(const DistanceMap& d, size_t& girth, Tag)
-{
-  return girth_recorder<DistanceMap, Tag>(d, girth);
-}
-
-}
-
+#include "sweep.h"
+
+/* \brief Length of the shortest cycle in g, or
+ *        std::numeric_limits<size_t>::max() if g is acyclic.
+ *
+ * The shortest cycle through a vertex s is closed by the first edge back to
+ * s found by a BFS from s.
+ */
 template <typename Graph>
 size_t girth(const Graph& g)
 {
   cpplog(cpplogging::verbose) << "Computing girth" << std::endl;
-  typedef typename boost::graph_traits<Graph>::vertices_size_type vertex_size_t;
-  typename boost::graph_traits<Graph>::vertex_iterator i, end;
-
-  size_t result = std::numeric_limits<size_t>::max();
-
-  for (boost::tie(i, end) = vertices(g); i != end; ++i)
-  {
-    std::vector<vertex_size_t> d(num_vertices(g), 0);
-    boost::breadth_first_search(g, *i,
-      boost::visitor(boost::make_bfs_visitor(std::make_pair(
-        boost::record_distances(&d[0], boost::on_tree_edge()), std::make_pair(
-        detail::record_girth(d, result, boost::on_black_target()),
-        detail::record_girth(d, result, boost::on_gray_target()))))
-      ));
-
-  }
-  return result;
+  sweep_options options;
+  options.girth = true;
+  return all_sources_sweep(g, options).girth;
 }
 
 #endif // GIRTH_H
@@ -0,0 +1,252 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file graph_statistics.h
+/// \brief Degree, owner and priority statistics of a game, computed in one
+///        sweep over the vertices.
+///
+/// The degrees and labels are first copied into flat arrays; all statistics
+/// are then obtained from simple loops over those arrays, which the compiler
+/// can vectorise, on blocks of vertices that are distributed over the
+/// threads.
+
+#ifndef GRAPH_STATISTICS_H
+#define GRAPH_STATISTICS_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "parallel.h"
+#include "pg.h"
+
+struct degree_statistics_t
+{
+  size_t min;
+  size_t max;
+  size_t sum;
+  std::vector<size_t> histogram; ///< histogram[d] is the number of vertices of degree d.
+
+  degree_statistics_t()
+    : min(std::numeric_limits<size_t>::max()), max(0), sum(0)
+  {}
+};
+
+struct graph_statistics_t
+{
+  size_t vertices;
+  size_t edges;
+  size_t even_vertices;
+  size_t odd_vertices;
+  degree_statistics_t degree; ///< in-degree plus out-degree
+  degree_statistics_t in_degree;
+  degree_statistics_t out_degree;
+  std::vector<std::pair<priority_t, size_t> > priorities; ///< number of vertices per priority, by increasing priority
+
+  graph_statistics_t()
+    : vertices(0), edges(0), even_vertices(0), odd_vertices(0)
+  {}
+};
+
+namespace detail
+{
+
+/// \brief Minimum, maximum and sum of degrees[first, last) folded into
+///        result.
+inline
+void degree_bounds(const std::vector<size_t>& degrees, size_t first, size_t last, degree_statistics_t& result)
+{
+  size_t lo = result.min;
+  size_t hi = result.max;
+  size_t sum = 0;
+  for(size_t v = first; v < last; ++v)
+  {
+    lo = std::min(lo, degrees[v]);
+    hi = std::max(hi, degrees[v]);
+    sum += degrees[v];
+  }
+  result.min = lo;
+  result.max = hi;
+  result.sum += sum;
+}
+
+inline
+void merge_degree_bounds(const degree_statistics_t& local, degree_statistics_t& result)
+{
+  result.min = std::min(result.min, local.min);
+  result.max = std::max(result.max, local.max);
+  result.sum += local.sum;
+}
+
+/// \brief Thread-local partial statistics.
+struct graph_statistics_block
+{
+  degree_statistics_t degree;
+  degree_statistics_t in_degree;
+  degree_statistics_t out_degree;
+  size_t even_vertices;
+  priority_t max_priority;
+  std::vector<size_t> priorities; ///< counts indexed by priority; only used for dense priorities
+
+  graph_statistics_block()
+    : even_vertices(0), max_priority(0)
+  {}
+};
+
+inline
+void add_histograms(const std::vector<std::vector<size_t> >& local, std::vector<size_t>& result)
+{
+  for(const std::vector<size_t>& h: local)
+  {
+    for(size_t d = 0; d < h.size(); ++d)
+      result[d] += h[d];
+  }
+}
+
+} // namespace detail
+
+/* \brief Determine the number of vertices and edges, the degree statistics
+ *        and histograms, and the number of vertices per owner and priority.
+ *
+ * As in avg_degree, the average degree is edges/vertices, whereas the degree
+ * of a vertex is the sum of its in- and out-degree.
+ */
+template <typename Graph>
+inline
+graph_statistics_t graph_statistics(const Graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing graph statistics" << std::endl;
+  const size_t n = boost::num_vertices(g);
+  graph_statistics_t result;
+  result.vertices = n;
+  result.edges = boost::num_edges(g);
+
+  std::vector<size_t> in(n);
+  std::vector<size_t> out(n);
+  std::vector<size_t> total(n);
+  std::vector<priority_t> prio(n);
+  std::vector<char> is_even(n);
+  parallel_for(0, n, [&](size_t v, size_t)
+  {
+    in[v] = boost::in_degree(v, g);
+    out[v] = boost::out_degree(v, g);
+    prio[v] = g[v].prio;
+    is_even[v] = g[v].player == even;
+  }, 4096);
+
+  const size_t block_size = 65536;
+  const size_t blocks = (n + block_size - 1)/block_size;
+  std::vector<detail::graph_statistics_block> locals(num_threads());
+
+  // Pass 1: bounds, sums and owners.
+  parallel_for(0, blocks, [&](size_t b, size_t thread)
+  {
+    const size_t first = b*block_size;
+    const size_t last = std::min(n, first + block_size);
+    detail::graph_statistics_block& local = locals[thread];
+    for(size_t v = first; v < last; ++v)
+      total[v] = in[v] + out[v];
+    detail::degree_bounds(total, first, last, local.degree);
+    detail::degree_bounds(in, first, last, local.in_degree);
+    detail::degree_bounds(out, first, last, local.out_degree);
+    size_t evens = 0;
+    priority_t max_priority = local.max_priority;
+    for(size_t v = first; v < last; ++v)
+    {
+      evens += is_even[v];
+      max_priority = std::max(max_priority, prio[v]);
+    }
+    local.even_vertices += evens;
+    local.max_priority = max_priority;
+  });
+
+  priority_t max_priority = 0;
+  for(const detail::graph_statistics_block& local: locals)
+  {
+    detail::merge_degree_bounds(local.degree, result.degree);
+    detail::merge_degree_bounds(local.in_degree, result.in_degree);
+    detail::merge_degree_bounds(local.out_degree, result.out_degree);
+    result.even_vertices += local.even_vertices;
+    max_priority = std::max(max_priority, local.max_priority);
+  }
+  result.odd_vertices = n - result.even_vertices;
+  if(n == 0)
+    return result;
+
+  // Pass 2: histograms, and priority counts if the priorities are dense.
+  const bool dense = max_priority <= 2*n;
+  std::vector<std::vector<size_t> > degree_histograms(num_threads());
+  std::vector<std::vector<size_t> > in_histograms(num_threads());
+  std::vector<std::vector<size_t> > out_histograms(num_threads());
+  parallel_for(0, blocks, [&](size_t b, size_t thread)
+  {
+    const size_t first = b*block_size;
+    const size_t last = std::min(n, first + block_size);
+    std::vector<size_t>& hd = degree_histograms[thread];
+    std::vector<size_t>& hi = in_histograms[thread];
+    std::vector<size_t>& ho = out_histograms[thread];
+    std::vector<size_t>& hp = locals[thread].priorities;
+    if(hd.empty())
+    {
+      hd.assign(result.degree.max + 1, 0);
+      hi.assign(result.in_degree.max + 1, 0);
+      ho.assign(result.out_degree.max + 1, 0);
+      if(dense)
+        hp.assign(max_priority + 1, 0);
+    }
+    for(size_t v = first; v < last; ++v)
+    {
+      ++hd[total[v]];
+      ++hi[in[v]];
+      ++ho[out[v]];
+    }
+    if(dense)
+    {
+      for(size_t v = first; v < last; ++v)
+        ++hp[prio[v]];
+    }
+  });
+
+  result.degree.histogram.assign(result.degree.max + 1, 0);
+  result.in_degree.histogram.assign(result.in_degree.max + 1, 0);
+  result.out_degree.histogram.assign(result.out_degree.max + 1, 0);
+  detail::add_histograms(degree_histograms, result.degree.histogram);
+  detail::add_histograms(in_histograms, result.in_degree.histogram);
+  detail::add_histograms(out_histograms, result.out_degree.histogram);
+
+  if(dense)
+  {
+    std::vector<size_t> counts(max_priority + 1, 0);
+    for(const detail::graph_statistics_block& local: locals)
+    {
+      for(size_t p = 0; p < local.priorities.size(); ++p)
+        counts[p] += local.priorities[p];
+    }
+    for(size_t p = 0; p < counts.size(); ++p)
+    {
+      if(counts[p] > 0)
+        result.priorities.push_back(std::make_pair(p, counts[p]));
+    }
+  }
+  else
+  {
+    // Sparse priorities; count runs in the sorted priorities instead.
+    std::sort(prio.begin(), prio.end());
+    for(size_t v = 0; v < n; )
+    {
+      size_t w = v;
+      while(w < n && prio[w] == prio[v])
+        ++w;
+      result.priorities.push_back(std::make_pair(prio[v], w - v));
+      v = w;
+    }
+  }
+  return result;
+}
+
+#endif // GRAPH_STATISTICS_H
@@ -0,0 +1,219 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file hyperanf.h
+/// \brief Approximate neighbourhood function using HyperLogLog counters, as
+///        described in P. Boldi, M. Rosa and S. Vigna, "HyperANF:
+///        Approximating the Neighbourhood Function of Very Large Graphs on a
+///        Budget", Proc. WWW 2011.
+///
+/// Every vertex v keeps a HyperLogLog counter estimating the size of the ball
+/// B(v, r) of vertices at distance at most r from v. The counter for radius
+/// r+1 is the union of the counter of v and those of its successors for
+/// radius r. A union of HyperLogLog counters is the register-wise maximum.
+
+#ifndef HYPERANF_H
+#define HYPERANF_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "csr.h"
+#include "parallel.h"
+#include "simd.h"
+
+struct approximate_neighbourhood_result
+{
+  double min;
+  double max;
+  double avg;
+
+  approximate_neighbourhood_result()
+    : min(std::numeric_limits<double>::max()), max(0), avg(0)
+  {}
+};
+
+namespace detail
+{
+
+/// \brief Mixing function of splitmix64; used to hash vertex numbers.
+inline
+uint64_t hash_vertex(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/// \brief A set of HyperLogLog counters with 2^precision registers each.
+class hyperloglog_counters
+{
+protected:
+  size_t m_precision;
+  size_t m_registers;
+  std::vector<uint8_t> m_data;
+
+public:
+  hyperloglog_counters(size_t n, size_t precision)
+    : m_precision(precision),
+      m_registers(size_t(1) << precision),
+      m_data(n << precision, 0)
+  {}
+
+  size_t registers() const
+  {
+    return m_registers;
+  }
+
+  uint8_t* counter(size_t v)
+  {
+    return m_data.data() + (v << m_precision);
+  }
+
+  const uint8_t* counter(size_t v) const
+  {
+    return m_data.data() + (v << m_precision);
+  }
+
+  /// \brief Add element x to counter v.
+  void add(size_t v, uint64_t x)
+  {
+    const uint64_t h = hash_vertex(x);
+    const size_t index = h >> (64 - m_precision);
+    // rank of the first 1-bit in the remaining bits, at most 64-precision+1
+    const uint64_t rest = (h << m_precision) | (uint64_t(1) << (m_precision - 1));
+    const uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    uint8_t& r = counter(v)[index];
+    if(rank > r)
+      r = rank;
+  }
+
+  /// \brief Estimated number of distinct elements in counter v.
+  double estimate(size_t v) const
+  {
+    const uint8_t* c = counter(v);
+    const double m = static_cast<double>(m_registers);
+    double sum = 0;
+    size_t zeros = 0;
+    for(size_t i = 0; i < m_registers; ++i)
+    {
+      sum += std::ldexp(1.0, -static_cast<int>(c[i]));
+      if(c[i] == 0)
+        ++zeros;
+    }
+
+    double alpha;
+    switch(m_registers)
+    {
+      case 16: alpha = 0.673; break;
+      case 32: alpha = 0.697; break;
+      case 64: alpha = 0.709; break;
+      default: alpha = 0.7213/(1.0 + 1.079/m);
+    }
+    const double e = alpha * m * m / sum;
+    if(e <= 2.5 * m && zeros > 0)
+      return m * std::log(m / static_cast<double>(zeros)); // linear counting
+    return e;
+  }
+
+  void swap(hyperloglog_counters& other)
+  {
+    std::swap(m_precision, other.m_precision);
+    std::swap(m_registers, other.m_registers);
+    m_data.swap(other.m_data);
+  }
+};
+
+} // namespace detail
+
+/// \brief Relative standard error of a HyperLogLog counter with
+///        2^precision registers.
+inline
+double hyperloglog_relative_error(size_t precision)
+{
+  return 1.04/std::sqrt(static_cast<double>(size_t(1) << precision));
+}
+
+/* \brief Estimate the minimal, maximal and average size of the
+ *        r-neighbourhoods of all vertices, for all r <= k.
+ *
+ * As in accumulated_upto_kneighbourhood, a vertex does not belong to its own
+ * neighbourhood. Every estimate has relative standard error
+ * hyperloglog_relative_error(precision); memory use is two counters of
+ * 2^precision bytes per vertex. Rounds are stopped as soon as no counter
+ * changes, since the neighbourhoods have then reached their final size.
+ *
+ * \pre 4 <= precision <= 16
+ */
+template<typename Graph>
+inline
+std::vector<approximate_neighbourhood_result>
+approximate_upto_kneighbourhood(const Graph& g, const size_t k, const size_t precision = 6)
+{
+  cpplog(cpplogging::verbose) << "Approximating neighbourhood function using HyperLogLog counters" << std::endl;
+  assert(4 <= precision && precision <= 16);
+  const csr_graph c = make_csr(g);
+  const size_t n = c.num_vertices();
+
+  detail::hyperloglog_counters current(n, precision);
+  detail::hyperloglog_counters next(n, precision);
+  for(size_t v = 0; v < n; ++v)
+    current.add(v, v);
+
+  std::vector<approximate_neighbourhood_result> result(k+1);
+  std::vector<double> estimates(n);
+  std::vector<char> changed(num_threads());
+  for(size_t r = 0; r <= k; ++r)
+  {
+    if(r > 0)
+    {
+      std::fill(changed.begin(), changed.end(), 0);
+      parallel_for(0, n, [&](size_t v, size_t thread)
+      {
+        uint8_t* target = next.counter(v);
+        std::copy(current.counter(v), current.counter(v) + current.registers(), target);
+        for(const csr_vertex_t* w = c.begin(v); w != c.end(v); ++w)
+        {
+          if(max_bytes(target, current.counter(*w), current.registers()))
+            changed[thread] = 1;
+        }
+      }, 256);
+      current.swap(next);
+
+      if(std::find(changed.begin(), changed.end(), 1) == changed.end())
+      {
+        cpplog(cpplogging::verbose) << "Neighbourhood function stabilised at radius " << r-1 << std::endl;
+        std::fill(result.begin() + r, result.end(), result[r-1]);
+        break;
+      }
+    }
+
+    parallel_for(0, n, [&](size_t v, size_t)
+    {
+      // Exclude v itself, as in accumulated_upto_kneighbourhood.
+      estimates[v] = std::max(0.0, current.estimate(v) - 1.0);
+    }, 256);
+
+    double sum = 0;
+    for(double e: estimates)
+    {
+      result[r].min = std::min(result[r].min, e);
+      result[r].max = std::max(result[r].max, e);
+      sum += e;
+    }
+    result[r].avg = n == 0 ? 0 : sum/static_cast<double>(n);
+  }
+  return result;
+}
+
+#endif // HYPERANF_H
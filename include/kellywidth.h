@@ -12,51 +12,20 @@
 #ifndef KELLYWIDTH_H
 #define KELLYWIDTH_H
 
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#include "cpplogging/logger.h"
 #include "cpplogging/progress_meter.h"
 
+#include "anytime.h"
+#include "bucket_queue.h"
+#include "directed_elimination_graph.h"
+#include "parallel.h"
+
 namespace detail
 {
-/* \brief Eliminate a vertex v.
- *
- * v is eliminated by adding edges u > w for all u,w s.t. u -> v -> w, u != w.
- * Priority pq is updated accordingly.
- *
- * \pre v \not \in pq.
- */
-template <typename DirectedGraph, class PriorityQueue, class HandleMap>
-inline
-void eliminate_vertex_directed(typename boost::graph_traits<DirectedGraph>::vertex_descriptor v,
-                   DirectedGraph& g,
-                   PriorityQueue& pq,
-                   HandleMap& handle)
-{
-  typedef typename boost::graph_traits<DirectedGraph>::vertex_descriptor vertex_t;
-  typename boost::graph_traits<DirectedGraph>::in_edge_iterator ii, iend;
-  typename boost::graph_traits<DirectedGraph>::out_edge_iterator oi, oend;
-
-  boost::tie(ii, iend) = boost::in_edges(v, g);
-  while(ii != iend)
-  {
-    vertex_t u = boost::source(*ii,g);
-    for (boost::tie(oi, oend) = boost::out_edges(v, g); oi != oend; ++oi)
-    {
-      vertex_t w = boost::target(*oi,g);
-      if(u != v && w != v && u != w)
-      {
-        boost::add_edge(u, w, g);
-        pq.decrease(handle[u]);
-      }
-    }
-    ii++;
-    boost::remove_edge(u, v, g);
-    // no pq.increase(handle[v]) since v is not in pq.
-    if(u != v)
-      pq.increase(handle[u]);
-  }
-  boost::clear_vertex(v, g);
-  boost::tie(oi, oend) = boost::out_edges(v, g);
-  assert(oi == oend);
-}
 
 /* \brief Compute the width of a directed elimination ordering.
  *
@@ -76,56 +45,79 @@ void eliminate_vertex_directed(typename boost::graph_traits<DirectedGraph>::vert
  * In this implementation we dynamically build an elimination ordering by,
  * at each step in the algorithm, removing a vertex with the smallest out-degree.
  * Note that this still just gives an upperbound on the Kelly-width.
+ *
+ * Vertices are kept in a bucket queue by out-degree; eliminating v only
+ * changes the out-degrees of its predecessors. If ordering is given, the
+ * elimination ordering is appended to it. If random is given, the vertices
+ * enter the queue in random order, which breaks the initial ties randomly.
  */
-template <typename DirectedGraph>
 inline
-typename boost::graph_traits<DirectedGraph>::vertices_size_type
-elimination_ordering_destructive(DirectedGraph& g)
+size_t elimination_ordering_destructive(directed_elimination_graph& g, std::vector<size_t>* ordering = 0,
+                                        std::mt19937* random = 0)
 {
-  typedef typename boost::graph_traits<DirectedGraph>::vertices_size_type vertex_size_t;
-  typedef typename boost::graph_traits<DirectedGraph>::vertex_descriptor vertex_t;
-  cpplogging::progress_meter progress(boost::num_vertices(g));
+  cpplogging::progress_meter progress(g.num_vertices());
 
-  // Build priority queue, sorted by outdegree, and record the handles.
-  typedef outdegree_greater<DirectedGraph> cmp_t;
-  typedef boost::heap::fibonacci_heap<vertex_t, boost::heap::compare<cmp_t> > priority_queue_t;
-  typedef typename priority_queue_t::handle_type handle_t;
-  cmp_t cmp(g);
-  priority_queue_t pq(cmp);
-  std::vector<handle_t> handles;
-
-  typename boost::graph_traits<DirectedGraph>::vertex_iterator i, end;
-  for(boost::tie(i,end) = boost::vertices(g); i != end; ++i)
+  // Out-degrees include self-loops, so they range up to the number of vertices.
+  bucket_queue queue(g.universe(), g.universe());
+  for(size_t v: tie_breaking_order(g.universe(), random))
   {
-    handles.push_back(pq.push(*i));
+    if(!g.removed(v))
+      queue.push(v, g.out_degree(v));
   }
 
   // Compute the upperbound according to the dynamically computed elimination
-  // ordering. Upperbound is maximum of the outdegrees of the verticese we
+  // ordering. Upperbound is maximum of the outdegrees of the vertices we
   // remove.
-  vertex_size_t upperbound = std::numeric_limits<vertex_size_t>::min();
-
-  while(!pq.empty())
+  size_t upperbound = 0;
+  while(!queue.empty())
   {
     progress.step();
-    vertex_t u = pq.top();
-    pq.pop();
-    upperbound = std::max(upperbound, boost::out_degree(u, g));
-    eliminate_vertex_directed(u, g, pq, handles);
+    const size_t u = queue.pop();
+    upperbound = std::max(upperbound, g.out_degree(u));
+    if(ordering)
+      ordering->push_back(u);
+    g.eliminate(u, [&](size_t w) { queue.update(w, g.out_degree(w)); });
   }
   return upperbound;
-
-}
 }
 
+} // namespace detail
+
+/// \brief Upper bound on the Kelly-width of g by eliminating vertices of
+///        minimum out-degree; edges of an undirected g count in both
+///        directions.
 template <typename DirectedGraph>
 inline
 typename boost::graph_traits<DirectedGraph>::vertices_size_type
 elimination_ordering(const DirectedGraph& g)
 {
-  DirectedGraph destructable_g;
-  boost::copy_graph(g, destructable_g);
+  cpplog(cpplogging::verbose) << "Computing Kelly-width upper bound" << std::endl;
+  directed_elimination_graph destructable_g(g);
   return detail::elimination_ordering_destructive(destructable_g);
 }
 
+/* \brief Anytime upper bound on the Kelly-width of g by restarting the
+ *        elimination ordering with random tie-breaking, until b is
+ *        exhausted.
+ *
+ * The first restart breaks ties as elimination_ordering does. Every thread
+ * reuses one elimination graph, into which g is copied at the start of each
+ * of its restarts.
+ */
+template <typename DirectedGraph>
+inline
+anytime_upper_bound_t anytime_kellywidth_upper_bound(const DirectedGraph& g, budget& b)
+{
+  cpplog(cpplogging::verbose) << "Computing anytime Kelly-width upper bound" << std::endl;
+  const directed_elimination_graph original(g);
+  std::vector<directed_elimination_graph> graphs(num_threads(), original);
+  return anytime_upper_bound([&](size_t seed, size_t thread, std::vector<size_t>& ordering)
+  {
+    directed_elimination_graph& h = graphs[thread];
+    h = original;
+    std::mt19937 random(seed);
+    return detail::elimination_ordering_destructive(h, &ordering, seed == 0 ? 0 : &random);
+  }, b);
+}
+
 #endif // KELLYWIDTH_H
@@ -0,0 +1,407 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file motif.h
+/// \brief Census of small labelled patterns (motifs) in a parity game.
+///
+/// All requested patterns are counted in a single pass over the vertices.
+/// Every occurrence is counted once in total, and additionally once for every
+/// label that all of its vertices share: owned by even, owned by odd, even
+/// priority, odd priority.
+///
+/// To count labelled occurrences with plain set intersections, the vertices
+/// are renumbered such that vertices with the same owner and priority parity
+/// get consecutive numbers. The successors of a vertex with a given label
+/// then form a contiguous range of its sorted successor array.
+
+#ifndef MOTIF_H
+#define MOTIF_H
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "csr.h"
+#include "parallel.h"
+#include "pg.h"
+#include "simd.h"
+
+enum motif_t
+{
+  two_cycle,         ///< u -> v -> u, for u != v
+  directed_triangle, ///< u -> v -> w -> u, for distinct u, v, w
+  out_star,          ///< a vertex with k distinct successors other than itself
+  in_star,           ///< a vertex with k distinct predecessors other than itself
+  diamond_motif      ///< a 2-diamond, see diamond_count
+};
+
+struct motif_pattern
+{
+  motif_t kind;
+  size_t leaves; ///< number of leaves k of a star, ignored otherwise
+
+  motif_pattern(motif_t kind_, size_t leaves_ = 2)
+    : kind(kind_), leaves(leaves_)
+  {}
+};
+
+inline
+std::string to_string(const motif_pattern& p)
+{
+  switch(p.kind)
+  {
+    case two_cycle: return "2-cycles";
+    case directed_triangle: return "Directed triangles";
+    case out_star: return "Out-stars (" + std::to_string(p.leaves) + " leaves)";
+    case in_star: return "In-stars (" + std::to_string(p.leaves) + " leaves)";
+    case diamond_motif: return "Diamonds";
+  }
+  return "Unknown";
+}
+
+/// \brief The patterns reported by default.
+inline
+std::vector<motif_pattern> default_motifs()
+{
+  std::vector<motif_pattern> result;
+  result.push_back(motif_pattern(two_cycle));
+  result.push_back(motif_pattern(directed_triangle));
+  result.push_back(motif_pattern(out_star));
+  result.push_back(motif_pattern(in_star));
+  result.push_back(motif_pattern(diamond_motif));
+  return result;
+}
+
+struct motif_count_t
+{
+  size_t all;
+  size_t even;          ///< all vertices owned by even
+  size_t odd;           ///< all vertices owned by odd
+  size_t even_priority; ///< all vertices have an even priority
+  size_t odd_priority;  ///< all vertices have an odd priority
+
+  motif_count_t()
+    : all(0), even(0), odd(0), even_priority(0), odd_priority(0)
+  {}
+
+  motif_count_t& operator+=(const motif_count_t& other)
+  {
+    all += other.all;
+    even += other.even;
+    odd += other.odd;
+    even_priority += other.even_priority;
+    odd_priority += other.odd_priority;
+    return *this;
+  }
+};
+
+namespace detail
+{
+
+/// \brief Labels of a vertex; a set of labels is a bit mask.
+enum motif_label_t
+{
+  label_even_owner = 1,
+  label_odd_owner = 2,
+  label_even_priority = 4,
+  label_odd_priority = 8,
+  all_labels = 15
+};
+
+/* \brief Game with vertices renumbered by label class.
+ *
+ * Class c = 2*owner + (priority % 2) occupies the vertex numbers
+ * [m_class_first[c], m_class_first[c+1]).
+ */
+class labelled_graph
+{
+protected:
+  csr_graph m_successors;
+  csr_graph m_predecessors;
+  size_t m_class_first[5];
+
+public:
+  template <typename Graph>
+  labelled_graph(const Graph& g)
+  {
+    const size_t n = boost::num_vertices(g);
+    std::vector<size_t> count(5, 0);
+    for(size_t v = 0; v < n; ++v)
+      ++count[motif_class(g[v].player, g[v].prio) + 1];
+    for(size_t c = 0; c < 4; ++c)
+      count[c+1] += count[c];
+    std::copy(count.begin(), count.end(), m_class_first);
+
+    std::vector<csr_vertex_t> renumber(n);
+    for(size_t v = 0; v < n; ++v)
+      renumber[v] = static_cast<csr_vertex_t>(count[motif_class(g[v].player, g[v].prio)]++);
+    std::vector<size_t> original(n);
+    for(size_t v = 0; v < n; ++v)
+      original[renumber[v]] = v;
+
+    std::vector<size_t> offsets(n + 1, 0);
+    std::vector<csr_vertex_t> targets;
+    targets.reserve(boost::num_edges(g));
+    typename boost::graph_traits<Graph>::adjacency_iterator ai, aend;
+    for(size_t v = 0; v < n; ++v)
+    {
+      const size_t first = targets.size();
+      for(boost::tie(ai, aend) = boost::adjacent_vertices(original[v], g); ai != aend; ++ai)
+        targets.push_back(renumber[*ai]);
+      std::sort(targets.begin() + first, targets.end());
+      targets.erase(std::unique(targets.begin() + first, targets.end()), targets.end());
+      offsets[v + 1] = targets.size();
+    }
+    m_successors = csr_graph(std::move(offsets), std::move(targets));
+    m_predecessors = make_reverse_csr(m_successors);
+  }
+
+  static size_t motif_class(player_t owner, priority_t prio)
+  {
+    return 2*static_cast<size_t>(owner) + prio % 2;
+  }
+
+  const csr_graph& successors() const
+  {
+    return m_successors;
+  }
+
+  const csr_graph& predecessors() const
+  {
+    return m_predecessors;
+  }
+
+  size_t class_first(size_t c) const
+  {
+    return m_class_first[c];
+  }
+
+  unsigned labels(size_t v) const
+  {
+    size_t c = 0;
+    while(m_class_first[c+1] <= v)
+      ++c;
+    return ((c < 2) ? label_even_owner : label_odd_owner)
+         | ((c % 2 == 0) ? label_even_priority : label_odd_priority);
+  }
+};
+
+inline
+bool less_than_value(csr_vertex_t x, size_t y)
+{
+  return x < y;
+}
+
+/// \brief Sub-range of the sorted array [first, last) with values in [lo, hi).
+inline
+std::pair<const csr_vertex_t*, const csr_vertex_t*>
+value_range(const csr_vertex_t* first, const csr_vertex_t* last, size_t lo, size_t hi)
+{
+  const csr_vertex_t* b = std::lower_bound(first, last, lo, less_than_value);
+  const csr_vertex_t* e = std::lower_bound(b, last, hi, less_than_value);
+  return std::make_pair(b, e);
+}
+
+/// \brief Number of common elements of two sorted arrays in [lo, hi).
+inline
+size_t common_in_range(const csr_vertex_t* a, const csr_vertex_t* a_end,
+                       const csr_vertex_t* b, const csr_vertex_t* b_end,
+                       size_t lo, size_t hi)
+{
+  if(lo >= hi)
+    return 0;
+  std::pair<const csr_vertex_t*, const csr_vertex_t*> ra = value_range(a, a_end, lo, hi);
+  std::pair<const csr_vertex_t*, const csr_vertex_t*> rb = value_range(b, b_end, lo, hi);
+  return intersection_size(ra.first, ra.second, rb.first, rb.second);
+}
+
+/// \brief Classes making up the vertices carrying a single label.
+inline
+void label_classes(unsigned label, size_t& c1, size_t& c2)
+{
+  switch(label)
+  {
+    case label_even_owner: c1 = 0; c2 = 1; break;
+    case label_odd_owner: c1 = 2; c2 = 3; break;
+    case label_even_priority: c1 = 0; c2 = 2; break;
+    default: c1 = 1; c2 = 3; break;
+  }
+}
+
+inline
+size_t& label_count(motif_count_t& count, unsigned label)
+{
+  switch(label)
+  {
+    case label_even_owner: return count.even;
+    case label_odd_owner: return count.odd;
+    case label_even_priority: return count.even_priority;
+    default: return count.odd_priority;
+  }
+}
+
+/* \brief Count the vertices x in [lo, hi) that are in both a and b, in total
+ *        and for every label shared by x and the vertices fixed so far.
+ *
+ * \param fixed labels shared by all other vertices of the pattern.
+ */
+inline
+void count_completions(const labelled_graph& g,
+                       const csr_vertex_t* a, const csr_vertex_t* a_end,
+                       const csr_vertex_t* b, const csr_vertex_t* b_end,
+                       size_t lo, size_t hi, unsigned fixed, motif_count_t& result)
+{
+  const size_t total = common_in_range(a, a_end, b, b_end, lo, hi);
+  if(total == 0)
+    return;
+  result.all += total;
+  for(unsigned label = 1; label < all_labels; label <<= 1)
+  {
+    if((fixed & label) == 0)
+      continue;
+    size_t c1, c2;
+    label_classes(label, c1, c2);
+    label_count(result, label) +=
+        common_in_range(a, a_end, b, b_end, std::max(lo, g.class_first(c1)), std::min(hi, g.class_first(c1+1)))
+      + common_in_range(a, a_end, b, b_end, std::max(lo, g.class_first(c2)), std::min(hi, g.class_first(c2+1)));
+  }
+}
+
+/// \brief n choose k, saturating at the maximal size_t.
+inline
+size_t binomial(size_t n, size_t k)
+{
+  if(k > n)
+    return 0;
+  k = std::min(k, n - k);
+  size_t result = 1;
+  for(size_t i = 1; i <= k; ++i)
+  {
+    const size_t factor = n - k + i;
+    if(result > std::numeric_limits<size_t>::max() / factor)
+      return std::numeric_limits<size_t>::max();
+    result = result * factor / i; // exact, result * factor is divisible by i
+  }
+  return result;
+}
+
+/// \brief Count the k-stars with centre u in the adjacency list [a, a_end).
+inline
+void count_stars(const labelled_graph& g, size_t u,
+                 const csr_vertex_t* a, const csr_vertex_t* a_end,
+                 size_t k, motif_count_t& result)
+{
+  const bool self = std::binary_search(a, a_end, static_cast<csr_vertex_t>(u));
+  result.all += binomial((a_end - a) - (self ? 1 : 0), k);
+
+  const unsigned fixed = g.labels(u);
+  for(unsigned label = 1; label < all_labels; label <<= 1)
+  {
+    if((fixed & label) == 0)
+      continue;
+    size_t c1, c2;
+    label_classes(label, c1, c2);
+    std::pair<const csr_vertex_t*, const csr_vertex_t*> r1 = value_range(a, a_end, g.class_first(c1), g.class_first(c1+1));
+    std::pair<const csr_vertex_t*, const csr_vertex_t*> r2 = value_range(a, a_end, g.class_first(c2), g.class_first(c2+1));
+    // u has label, so if u is its own successor it is in one of the ranges.
+    label_count(result, label) += binomial((r1.second - r1.first) + (r2.second - r2.first) - (self ? 1 : 0), k);
+  }
+}
+
+/// \brief Add the occurrences of pattern p attributed to vertex u.
+inline
+void count_motif(const labelled_graph& g, const motif_pattern& p, size_t u, motif_count_t& result)
+{
+  const csr_graph& succ = g.successors();
+  const csr_graph& pred = g.predecessors();
+  const size_t n = succ.num_vertices();
+
+  switch(p.kind)
+  {
+    case two_cycle:
+    {
+      // Counted at the smallest vertex u.
+      count_completions(g, succ.begin(u), succ.end(u), pred.begin(u), pred.end(u), u+1, n, g.labels(u), result);
+      break;
+    }
+    case directed_triangle:
+    {
+      // Counted at the smallest vertex u, and distinguished by its successor v.
+      for(const csr_vertex_t* vi = succ.begin(u); vi != succ.end(u); ++vi)
+      {
+        const size_t v = *vi;
+        if(v <= u)
+          continue;
+        const unsigned fixed = g.labels(u) & g.labels(v);
+        count_completions(g, succ.begin(v), succ.end(v), pred.begin(u), pred.end(u), u+1, v, fixed, result);
+        count_completions(g, succ.begin(v), succ.end(v), pred.begin(u), pred.end(u), v+1, n, fixed, result);
+      }
+      break;
+    }
+    case out_star:
+      count_stars(g, u, succ.begin(u), succ.end(u), p.leaves, result);
+      break;
+    case in_star:
+      count_stars(g, u, pred.begin(u), pred.end(u), p.leaves, result);
+      break;
+    case diamond_motif:
+    {
+      // Labels are those of u, v and w, as in diamond_count.
+      for(const csr_vertex_t* vi = succ.begin(u); vi != succ.end(u); ++vi)
+      {
+        for(const csr_vertex_t* wi = vi + 1; wi != succ.end(u); ++wi)
+        {
+          const size_t k = intersection_size(succ.begin(*vi), succ.end(*vi), succ.begin(*wi), succ.end(*wi));
+          if(k == 0)
+            continue;
+          result.all += k;
+          const unsigned fixed = g.labels(u) & g.labels(*vi) & g.labels(*wi);
+          for(unsigned label = 1; label < all_labels; label <<= 1)
+          {
+            if(fixed & label)
+              label_count(result, label) += k;
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+} // namespace detail
+
+/* \brief Count the occurrences of all patterns in g in a single pass.
+ *
+ * The result contains the counts in the order of patterns.
+ */
+template <typename Graph>
+inline
+std::vector<motif_count_t> motif_census(const Graph& g, const std::vector<motif_pattern>& patterns = default_motifs())
+{
+  cpplog(cpplogging::verbose) << "Computing motif census" << std::endl;
+  const detail::labelled_graph lg(g);
+  const size_t n = boost::num_vertices(g);
+
+  std::vector<std::vector<motif_count_t> > counts(num_threads(), std::vector<motif_count_t>(patterns.size()));
+  parallel_for(0, n, [&](size_t u, size_t thread)
+  {
+    for(size_t i = 0; i < patterns.size(); ++i)
+      detail::count_motif(lg, patterns[i], u, counts[thread][i]);
+  }, 64);
+
+  std::vector<motif_count_t> result(patterns.size());
+  for(const std::vector<motif_count_t>& local: counts)
+  {
+    for(size_t i = 0; i < patterns.size(); ++i)
+      result[i] += local[i];
+  }
+  return result;
+}
+
+#endif // MOTIF_H
@@ -13,45 +13,141 @@
 #define NEIGHBOURHOOD_H
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <memory>
+#include <unordered_set>
+#include <vector>
 #include "cpplogging/logger.h"
-#include "cpplogging/progress_meter.h"
+#include "csr.h"
+#include "parallel.h"
+#include "simd.h"
 
+struct neighbourhood_result
+{
+  size_t min;
+  size_t max;
+  size_t sum;
+
+  neighbourhood_result()
+    : min(std::numeric_limits<size_t>::max()), max(0), sum(0)
+  {}
+};
+
+namespace detail
+{
+
+/* \brief Bounded BFS that is reused for many sources.
+ *
+ * Visited vertices are marked with the number of the current search (the
+ * epoch) instead of being inserted into a set, so starting a new search does
+ * not need to clear or allocate anything.
+ */
+class neighbourhood_engine
+{
+protected:
+  const csr_graph& m_g;
+  std::vector<uint32_t> m_visited; ///< epoch in which a vertex was last visited
+  uint32_t m_epoch;
+  std::vector<csr_vertex_t> m_queue;
+  std::vector<size_t> m_levels;
+
+  void next_epoch()
+  {
+    if(++m_epoch == 0) // wrapped around; forget all old marks
+    {
+      std::fill(m_visited.begin(), m_visited.end(), 0);
+      m_epoch = 1;
+    }
+  }
+
+public:
+  neighbourhood_engine(const csr_graph& g)
+    : m_g(g), m_visited(g.num_vertices(), 0), m_epoch(0)
+  {
+    m_queue.reserve(g.num_vertices());
+  }
+
+  /* \brief Determine for all i <= k the number of vertices at distance
+   *        1, ..., i from v in result[i].
+   *
+   * v itself does not belong to its neighbourhood, even if it is on a cycle.
+   */
+  void upto_kneighbourhood(size_t v, size_t k, std::vector<size_t>& result)
+  {
+    result.assign(k+1, 0);
+    next_epoch();
+    m_queue.clear();
+    m_queue.push_back(static_cast<csr_vertex_t>(v));
+    m_visited[v] = m_epoch;
+
+    size_t level_begin = 0;
+    for(size_t level = 1; level <= k && level_begin < m_queue.size(); ++level)
+    {
+      const size_t level_end = m_queue.size();
+      for(size_t i = level_begin; i < level_end; ++i)
+      {
+        const size_t u = m_queue[i];
+        for(const csr_vertex_t* w = m_g.begin(u); w != m_g.end(u); ++w)
+        {
+          if(m_visited[*w] != m_epoch)
+          {
+            m_visited[*w] = m_epoch;
+            m_queue.push_back(*w);
+          }
+        }
+      }
+      level_begin = level_end;
+      result[level] = m_queue.size() - 1;
+    }
+    // Levels beyond the reachable part do not add any vertices.
+    for(size_t level = 1; level <= k; ++level)
+      result[level] = std::max(result[level], result[level-1]);
+  }
+
+  /// \brief Number of vertices at distance 1, ..., k from v.
+  size_t kneighbourhood(size_t v, size_t k)
+  {
+    upto_kneighbourhood(v, k, m_levels);
+    return m_levels[k];
+  }
+};
+
+} // namespace detail
+
+/* \brief For all i <= k, the number of vertices at distance 1, ..., i from
+ *        v.
+ *
+ * The search runs on g directly and only touches the vertices it reaches,
+ * so a single query does not pay for the whole graph; to query all
+ * vertices, build one detail::neighbourhood_engine on a CSR of g instead.
+ */
 template<typename Graph>
 inline
 std::vector<typename boost::graph_traits<Graph>::vertices_size_type>
 upto_kneighbourhood(typename Graph::vertex_descriptor v, const Graph& g, const size_t k)
 {
-  typedef typename boost::graph_traits<Graph>::vertices_size_type vertex_size_t;
   typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_t;
-  std::set<vertex_t> visited;
-  std::vector<std::pair<vertex_t, size_t> > queue;
-  queue.push_back(std::make_pair(v, 0));
+  std::vector<typename boost::graph_traits<Graph>::vertices_size_type> result(k+1, 0);
+  std::unordered_set<vertex_t> visited;
+  std::vector<vertex_t> queue(1, v);
   visited.insert(v);
-  size_t current = 0; // current position in the queue
-  std::vector<vertex_size_t> result(k+1,0);
-  if(k == 0) return result;
 
-  while(current < queue.size())
+  size_t level_begin = 0;
+  for(size_t level = 1; level <= k; ++level)
   {
-    if(queue[current].second < k)
+    const size_t level_end = queue.size();
+    for(size_t i = level_begin; i < level_end; ++i)
     {
-      typename boost::graph_traits< Graph >::adjacency_iterator ai,aend;
-      for(boost::tie(ai, aend) = boost::adjacent_vertices(queue[current].first, g); ai != aend; ++ai)
+      typename boost::graph_traits<Graph>::adjacency_iterator w, end;
+      for(boost::tie(w, end) = boost::adjacent_vertices(queue[i], g); w != end; ++w)
       {
-        if(visited.find(*ai) == visited.end())
-        {
-          visited.insert(*ai);
-          queue.push_back(std::make_pair(*ai, queue[current].second + 1));
-        }
+        if(visited.insert(*w).second)
+          queue.push_back(*w);
       }
     }
-    ++current;
-  }
-
-  for(size_t i = 0; i <= k; ++i)
-  {
-    result[i] = std::count_if(queue.begin(), queue.end(), [&i](std::pair<vertex_size_t, size_t> x) { return 0 < x.second && x.second <= i; });
+    level_begin = level_end;
+    result[level] = queue.size() - 1;
   }
   return result;
 }
@@ -72,86 +168,215 @@ neighbourhood(typename Graph::vertex_descriptor v, const Graph& g)
   return upto_kneighbourhood(v, g, 1)[1];
 }
 
-struct neighbourhood_result
+namespace detail
 {
-  size_t min;
-  size_t max;
-  size_t sum;
 
-  neighbourhood_result()
-    : min(std::numeric_limits<size_t>::max()), max(0), sum(0)
-  {}
-};
+/// \brief Games with at most this many vertices use the bit matrix for the
+///        accumulated neighbourhood sizes.
+const size_t max_vertices_for_bit_matrix = 100000;
 
-template<typename Graph>
+/// \brief Number of bytes the bit matrix and its per-vertex counts may use.
+const size_t bit_matrix_budget = size_t(256) << 20;
+
+/// \brief Fold the per-vertex neighbourhood sizes in tmp into result.
 inline
-std::vector<neighbourhood_result>
-accumulated_upto_kneighbourhood(Graph& g, const size_t k)
+void accumulate_neighbourhood(const size_t* tmp, size_t k, std::vector<neighbourhood_result>& result)
 {
-  cpplog(cpplogging::verbose) << "Computing accumulated neighbourhood information" << std::endl;
-  cpplogging::progress_meter progress(boost::num_vertices(g));
+  for(size_t i = 0; i <= k; ++i)
+  {
+    result[i].sum += tmp[i];
+    result[i].min = std::min(result[i].min, tmp[i]);
+    result[i].max = std::max(result[i].max, tmp[i]);
+  }
+}
 
+/// \brief Combine the thread-local results of an accumulated neighbourhood
+///        computation.
+inline
+std::vector<neighbourhood_result>
+merge_neighbourhood_results(const std::vector<std::vector<neighbourhood_result> >& results, size_t k)
+{
   std::vector<neighbourhood_result> result(k+1, neighbourhood_result());
-  typename boost::graph_traits<Graph>::vertex_iterator i, end;
-  for (boost::tie(i, end) = vertices(g); i != end; ++i)
+  for(const std::vector<neighbourhood_result>& local: results)
   {
-    progress.step();
-
-    std::vector<typename boost::graph_traits<Graph>::vertices_size_type> tmp = upto_kneighbourhood(*i, g, k);
     for(size_t i = 0; i <= k; ++i)
     {
-      result[i].sum += tmp[i];
-      result[i].min = std::min(result[i].min, tmp[i]);
-      result[i].max = std::max(result[i].max, tmp[i]);
+      result[i].sum += local[i].sum;
+      result[i].min = std::min(result[i].min, local[i].min);
+      result[i].max = std::max(result[i].max, local[i].max);
     }
   }
-
   return result;
 }
 
+/* \brief Accumulated neighbourhood sizes using a bounded BFS from every
+ *        vertex.
+ *
+ * The sources are distributed over the threads; every thread reuses a single
+ * neighbourhood_engine for all of its sources.
+ */
+inline
+std::vector<neighbourhood_result>
+accumulated_upto_kneighbourhood_bfs(const csr_graph& c, const size_t k)
+{
+  std::vector<std::unique_ptr<neighbourhood_engine> > engines(num_threads());
+  std::vector<std::vector<size_t> > levels(num_threads());
+  std::vector<std::vector<neighbourhood_result> > results(num_threads(), std::vector<neighbourhood_result>(k+1));
 
-template<typename Graph>
+  parallel_for(0, c.num_vertices(), [&](size_t v, size_t thread)
+  {
+    if(!engines[thread])
+      engines[thread].reset(new neighbourhood_engine(c));
+    std::vector<size_t>& tmp = levels[thread];
+    engines[thread]->upto_kneighbourhood(v, k, tmp);
+    accumulate_neighbourhood(tmp.data(), k, results[thread]);
+  }, 64);
+
+  return merge_neighbourhood_results(results, k);
+}
+
+/* \brief Accumulated neighbourhood sizes by propagating reachability bits.
+ *
+ * Row v of the matrix for radius r is the set of vertices at distance at
+ * most r from v; the row for radius r+1 is the union of row v and the rows
+ * of the successors of v for radius r. The columns are processed in blocks
+ * of width bits (a multiple of 64), so only two n x width matrices are in
+ * memory at any time. Within a block, propagation stops as soon as no row
+ * changes.
+ */
 inline
-double avg_kneighbourhood(Graph& g, const size_t k)
+std::vector<neighbourhood_result>
+accumulated_upto_kneighbourhood_bit_matrix(const csr_graph& c, const size_t k, const size_t width)
 {
-  cpplog(cpplogging::verbose) << "Computing average " << k << " neighbourhood" << std::endl;
-  typename boost::graph_traits<Graph>::vertices_size_type sum = 0;
-  typename boost::graph_traits<Graph>::vertex_iterator i, end;
-  for (boost::tie(i, end) = vertices(g); i != end; ++i)
+  const size_t n = c.num_vertices();
+  const size_t words = width/64;
+  std::vector<uint32_t> counts(n*(k+1), 0); // row v holds |B(v, i)| for i <= k
+  std::vector<uint64_t> current(n*words);
+  std::vector<uint64_t> next(n*words);
+  std::vector<uint32_t> popcounts(n);
+  std::vector<char> changed(num_threads());
+
+  for(size_t block = 0; block < n; block += width)
   {
-    sum += kneighbourhood(*i, g, k);
+    std::fill(current.begin(), current.end(), 0);
+    for(size_t v = block; v < std::min(n, block + width); ++v)
+      current[v*words + (v - block)/64] |= uint64_t(1) << ((v - block) % 64);
+
+    size_t level = 0;
+    for(size_t v = 0; v < n; ++v)
+      popcounts[v] = (block <= v && v < block + width) ? 1 : 0;
+    for(; level <= k; ++level)
+    {
+      if(level > 0)
+      {
+        std::fill(changed.begin(), changed.end(), 0);
+        parallel_for(0, n, [&](size_t v, size_t thread)
+        {
+          uint64_t* row = next.data() + v*words;
+          std::copy(current.data() + v*words, current.data() + (v+1)*words, row);
+          for(const csr_vertex_t* w = c.begin(v); w != c.end(v); ++w)
+            or_words(row, current.data() + *w * words, words);
+          const uint32_t p = static_cast<uint32_t>(popcount_words(row, words));
+          if(p != popcounts[v])
+          {
+            popcounts[v] = p;
+            changed[thread] = 1;
+          }
+        }, 256);
+        current.swap(next);
+        if(std::find(changed.begin(), changed.end(), 1) == changed.end())
+          break;
+      }
+      for(size_t v = 0; v < n; ++v)
+        counts[v*(k+1) + level] += popcounts[v];
+    }
+    // The rows did not change anymore, so neither will the higher levels.
+    for(; level <= k; ++level)
+    {
+      for(size_t v = 0; v < n; ++v)
+        counts[v*(k+1) + level] += popcounts[v];
+    }
   }
-  return static_cast<double>(sum)/static_cast<double>(boost::num_vertices(g));
+
+  std::vector<std::vector<size_t> > levels(num_threads(), std::vector<size_t>(k+1));
+  std::vector<std::vector<neighbourhood_result> > results(num_threads(), std::vector<neighbourhood_result>(k+1));
+  parallel_for(0, n, [&](size_t v, size_t thread)
+  {
+    std::vector<size_t>& tmp = levels[thread];
+    // v itself does not belong to its neighbourhood.
+    for(size_t i = 0; i <= k; ++i)
+      tmp[i] = counts[v*(k+1) + i] - 1;
+    accumulate_neighbourhood(tmp.data(), k, results[thread]);
+  }, 1024);
+
+  return merge_neighbourhood_results(results, k);
+}
+
+/// \brief Width of the column blocks of the bit matrix for n vertices and
+///        radius k, or 0 if the bit matrix should not be used.
+inline
+size_t bit_matrix_width(size_t n, size_t k)
+{
+  // For k <= 1 the BFS only scans the successors of every vertex once.
+  if(n == 0 || n > max_vertices_for_bit_matrix || k <= 1)
+    return 0;
+  const size_t count_bytes = n*(k+1)*sizeof(uint32_t);
+  if(count_bytes >= bit_matrix_budget/2)
+    return 0;
+  // Two matrices of n rows, each width/8 bytes wide.
+  const size_t max_width = ((bit_matrix_budget - count_bytes)*8/(2*n)) / 64 * 64;
+  const size_t full_width = (n + 63) / 64 * 64;
+  return std::min(full_width, std::max(size_t(64), max_width));
+}
+
+} // namespace detail
+
+/* \brief Minimal, maximal and total size of the i-neighbourhoods of all
+ *        vertices, for all i <= k.
+ *
+ * Games with up to detail::max_vertices_for_bit_matrix vertices are handled
+ * by propagating reachability bit sets; larger games by a bounded BFS from
+ * every vertex. Both compute exactly the same result.
+ */
+template<typename Graph>
+inline
+std::vector<neighbourhood_result>
+accumulated_upto_kneighbourhood(const Graph& g, const size_t k)
+{
+  cpplog(cpplogging::verbose) << "Computing accumulated neighbourhood information" << std::endl;
+  const csr_graph c = make_csr(g);
+  const size_t width = detail::bit_matrix_width(c.num_vertices(), k);
+  if(width == 0)
+    return detail::accumulated_upto_kneighbourhood_bfs(c, k);
+
+  cpplog(cpplogging::verbose) << "Using bit matrix with blocks of " << width << " columns" << std::endl;
+  return detail::accumulated_upto_kneighbourhood_bit_matrix(c, k, width);
+}
+
+template<typename Graph>
+inline
+double avg_kneighbourhood(const Graph& g, const size_t k)
+{
+  cpplog(cpplogging::verbose) << "Computing average " << k << " neighbourhood" << std::endl;
+  return static_cast<double>(accumulated_upto_kneighbourhood(g, k)[k].sum)/static_cast<double>(boost::num_vertices(g));
 }
 
 template<typename Graph>
 inline
 typename boost::graph_traits<Graph>::vertices_size_type
-max_kneighbourhood(Graph& g, const size_t k)
+max_kneighbourhood(const Graph& g, const size_t k)
 {
   cpplog(cpplogging::verbose) << "Computing maximum " << k << " neighbourhood" << std::endl;
-  typename boost::graph_traits<Graph>::vertices_size_type result = 0;
-  typename boost::graph_traits<Graph>::vertex_iterator i, end;
-  for (boost::tie(i, end) = vertices(g); i != end; ++i)
-  {
-    result = std::max(result, kneighbourhood(*i, g, k));
-  }
-  return result;
+  return accumulated_upto_kneighbourhood(g, k)[k].max;
 }
 
 template<typename Graph>
 inline
 typename boost::graph_traits<Graph>::vertices_size_type
-min_kneighbourhood(Graph& g, const size_t k)
+min_kneighbourhood(const Graph& g, const size_t k)
 {
   cpplog(cpplogging::verbose) << "Computing minimum " << k << " neighbourhood" << std::endl;
-  typename boost::graph_traits<Graph>::vertices_size_type result = std::numeric_limits<size_t>::max();
-  typename boost::graph_traits<Graph>::vertex_iterator i, end;
-  for (boost::tie(i, end) = vertices(g); i != end; ++i)
-  {
-    result = std::min(result, kneighbourhood(*i, g, k));
-  }
-  return result;
+  return accumulated_upto_kneighbourhood(g, k)[k].min;
 }
 
 #endif // NEIGHBOURHOOD_H
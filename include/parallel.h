@@ -0,0 +1,129 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file parallel.h
+/// \brief Minimal thread pool primitives shared by the parallel measures.
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace detail
+{
+inline
+size_t& thread_setting()
+{
+  static size_t threads = 0; // 0 means use all hardware threads
+  return threads;
+}
+
+/// \brief x = min(x, y), atomically.
+inline
+void atomic_min(std::atomic<size_t>& x, size_t y)
+{
+  size_t current = x.load();
+  while(y < current && !x.compare_exchange_weak(current, y))
+  {}
+}
+
+/// \brief x = max(x, y), atomically.
+inline
+void atomic_max(std::atomic<size_t>& x, size_t y)
+{
+  size_t current = x.load();
+  while(y > current && !x.compare_exchange_weak(current, y))
+  {}
+}
+} // namespace detail
+
+/// \brief Set the number of threads used by the parallel measures.
+/// A value of 0 selects the number of hardware threads.
+inline
+void set_num_threads(size_t n)
+{
+  detail::thread_setting() = n;
+}
+
+/// \brief The number of threads used by the parallel measures.
+inline
+size_t num_threads()
+{
+  size_t n = detail::thread_setting();
+  if(n == 0)
+    n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+/* \brief Call f(i, t) for all i in [begin, end).
+ *
+ * Indices are handed out in chunks of size grain from a shared counter, so
+ * threads that finish early pick up remaining work (dynamic scheduling).
+ * t in [0, num_threads()) identifies the calling thread, and can be used to
+ * index thread-local state. The first exception thrown by f is rethrown in
+ * the calling thread.
+ */
+template <typename Function>
+inline
+void parallel_for(size_t begin, size_t end, Function f, size_t grain = 1)
+{
+  if(begin >= end)
+    return;
+  if(grain == 0)
+    grain = 1;
+
+  const size_t nthreads = std::min(num_threads(), (end - begin + grain - 1)/grain);
+  if(nthreads <= 1)
+  {
+    for(size_t i = begin; i < end; ++i)
+      f(i, size_t(0));
+    return;
+  }
+
+  std::atomic<size_t> next(begin);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&](size_t t)
+  {
+    try
+    {
+      for(size_t first = next.fetch_add(grain); first < end; first = next.fetch_add(grain))
+      {
+        const size_t last = std::min(end, first + grain);
+        for(size_t i = first; i < last; ++i)
+          f(i, t);
+      }
+    }
+    catch(...)
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if(!error)
+        error = std::current_exception();
+      next = end;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(nthreads - 1);
+  for(size_t t = 1; t < nthreads; ++t)
+    threads.push_back(std::thread(worker, t));
+  worker(0);
+  for(auto& t: threads)
+    t.join();
+
+  if(error)
+    std::rethrow_exception(error);
+}
+
+#endif // PARALLEL_H
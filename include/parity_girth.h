@@ -0,0 +1,193 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file parity_girth.h
+/// \brief Length of the shortest cycles won by either player.
+///
+/// A cycle is even-dominated if the maximal priority on it is even, and
+/// odd-dominated otherwise. The shortest cycle whose maximal priority is
+/// exactly p lives inside a single SCC of the subgame restricted to the
+/// vertices with priority at most p, and passes through a vertex with
+/// priority p. We therefore decompose the subgame for every priority p
+/// separately, and search for shortest cycles through the vertices with
+/// priority p within their SCC only.
+
+#ifndef PARITY_GIRTH_H
+#define PARITY_GIRTH_H
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <boost/graph/filtered_graph.hpp>
+#include <boost/graph/strong_components.hpp>
+#include "cpplogging/logger.h"
+#include "parallel.h"
+#include "pg.h"
+
+struct parity_girth_t
+{
+  size_t even; ///< Length of the shortest cycle with even maximal priority.
+  size_t odd;  ///< Length of the shortest cycle with odd maximal priority.
+
+  parity_girth_t()
+    : even(std::numeric_limits<size_t>::max()),
+      odd(std::numeric_limits<size_t>::max())
+  {}
+};
+
+namespace detail
+{
+
+template <typename Graph>
+struct priority_at_most
+{
+  const Graph* m_g;
+  priority_t m_p;
+
+  priority_at_most()
+    : m_g(0), m_p(0)
+  {}
+
+  priority_at_most(const Graph& g, priority_t p)
+    : m_g(&g), m_p(p)
+  {}
+
+  bool operator()(typename boost::graph_traits<Graph>::vertex_descriptor v) const
+  {
+    return (*m_g)[v].prio <= m_p;
+  }
+};
+
+/// \brief Per-thread buffers for parity_girth, reused across thresholds.
+struct parity_girth_buffers
+{
+  std::vector<size_t> component;
+  std::vector<size_t> distance;
+  std::vector<size_t> stamp;
+  std::vector<size_t> queue;
+  size_t epoch;
+
+  parity_girth_buffers(size_t n)
+    : component(n, 0), distance(n, 0), stamp(n, 0), epoch(0)
+  {
+    queue.reserve(n);
+  }
+};
+
+/* \brief Length of a shortest cycle through s that only visits vertices with
+ *        priority at most p in the SCC of s. Cycles of length at least bound
+ *        are not reported; bound is returned if no shorter cycle exists.
+ */
+template <typename Graph>
+inline
+size_t shortest_cycle_through(const Graph& g,
+                              typename boost::graph_traits<Graph>::vertex_descriptor s,
+                              priority_t p,
+                              size_t bound,
+                              parity_girth_buffers& b)
+{
+  typename boost::graph_traits<Graph>::adjacency_iterator ai, aend;
+
+  ++b.epoch;
+  b.queue.clear();
+  b.queue.push_back(s);
+  b.stamp[s] = b.epoch;
+  b.distance[s] = 0;
+
+  for(size_t current = 0; current < b.queue.size(); ++current)
+  {
+    const size_t u = b.queue[current];
+    const size_t d = b.distance[u] + 1; // length of paths via an edge of u
+    if(d >= bound)
+      break;
+
+    for(boost::tie(ai, aend) = boost::adjacent_vertices(u, g); ai != aend; ++ai)
+    {
+      const size_t w = *ai;
+      if(w == s)
+        return d; // BFS order, so this is the shortest cycle through s
+      if(g[w].prio > p || b.component[w] != b.component[s] || b.stamp[w] == b.epoch)
+        continue;
+      b.stamp[w] = b.epoch;
+      b.distance[w] = d;
+      b.queue.push_back(w);
+    }
+  }
+  return bound;
+}
+
+} // namespace detail
+
+/* \brief Compute the length of the shortest even-dominated and shortest
+ *        odd-dominated cycles in g.
+ *
+ * The thresholds are processed in parallel, starting with the highest
+ * priorities since those induce the largest subgames. Lengths are
+ * std::numeric_limits<size_t>::max() if no such cycle exists.
+ */
+template <typename Graph>
+inline
+parity_girth_t parity_girth(const Graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing shortest even- and odd-dominated cycles" << std::endl;
+  typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_t;
+  typedef boost::filtered_graph<Graph, boost::keep_all, detail::priority_at_most<Graph> > subgame_t;
+
+  const size_t n = boost::num_vertices(g);
+
+  // Bucket the vertices by priority, highest priority first.
+  std::vector<std::pair<priority_t, vertex_t> > by_priority;
+  by_priority.reserve(n);
+  typename boost::graph_traits<Graph>::vertex_iterator i, end;
+  for(boost::tie(i, end) = boost::vertices(g); i != end; ++i)
+    by_priority.push_back(std::make_pair(g[*i].prio, *i));
+  std::sort(by_priority.begin(), by_priority.end(), std::greater<std::pair<priority_t, vertex_t> >());
+
+  std::vector<size_t> thresholds; // start of each priority in by_priority
+  for(size_t j = 0; j < by_priority.size(); ++j)
+  {
+    if(j == 0 || by_priority[j].first != by_priority[j-1].first)
+      thresholds.push_back(j);
+  }
+  thresholds.push_back(by_priority.size());
+
+  std::atomic<size_t> best[2];
+  best[even] = std::numeric_limits<size_t>::max();
+  best[odd] = std::numeric_limits<size_t>::max();
+
+  std::vector<std::unique_ptr<detail::parity_girth_buffers> > buffers(num_threads());
+
+  parallel_for(0, thresholds.size() - 1, [&](size_t t, size_t thread)
+  {
+    if(!buffers[thread])
+      buffers[thread].reset(new detail::parity_girth_buffers(n));
+    detail::parity_girth_buffers& b = *buffers[thread];
+
+    const priority_t p = by_priority[thresholds[t]].first;
+    std::atomic<size_t>& result = best[p % 2];
+
+    subgame_t subgame(g, boost::keep_all(), detail::priority_at_most<Graph>(g, p));
+    boost::strong_components(subgame, &b.component[0]);
+
+    for(size_t j = thresholds[t]; j < thresholds[t+1]; ++j)
+    {
+      const size_t bound = result.load();
+      if(bound == 1)
+        break;
+      detail::atomic_min(result, detail::shortest_cycle_through(g, by_priority[j].second, p, bound, b));
+    }
+  });
+
+  parity_girth_t girths;
+  girths.even = best[even];
+  girths.odd = best[odd];
+  return girths;
+}
+
+#endif // PARITY_GIRTH_H
@@ -0,0 +1,181 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file priority_compression.h
+/// \brief Renumbering of priorities to a small, dense range.
+///
+/// Both transformations below preserve the parity of every priority, and
+/// for every cycle the parity of its maximal priority. The winner of every
+/// vertex therefore does not change.
+///
+/// renumber_priorities merges runs of consecutive priorities of the same
+/// parity, and numbers the runs 0, 1, 2, ... (or 1, 2, ... if the smallest
+/// priority is odd). compress_priorities additionally only preserves the
+/// order of priorities that occur in the same strongly connected component,
+/// as in the priority compression of O. Friedmann and M. Lange, "Solving
+/// Parity Games in Practice", ATVA 2009.
+
+#ifndef PRIORITY_COMPRESSION_H
+#define PRIORITY_COMPRESSION_H
+
+#include <algorithm>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "pg.h"
+#include "scc_decomposition.h"
+
+/// \brief Number of distinct priorities before and after compression.
+struct priority_compression_t
+{
+  size_t before;
+  size_t after;
+
+  priority_compression_t()
+    : before(0), after(0)
+  {}
+};
+
+/// \brief The distinct priorities of pg in increasing order.
+inline
+std::vector<priority_t> distinct_priorities(const parity_game_t& pg)
+{
+  std::vector<priority_t> result;
+  result.reserve(boost::num_vertices(pg));
+  for(size_t v = 0; v < boost::num_vertices(pg); ++v)
+    result.push_back(pg[v].prio);
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+namespace detail
+{
+
+/// \brief rank[v] is the position of the priority of v in priorities.
+inline
+std::vector<size_t> priority_ranks(const parity_game_t& pg, const std::vector<priority_t>& priorities)
+{
+  std::vector<size_t> rank(boost::num_vertices(pg));
+  for(size_t v = 0; v < rank.size(); ++v)
+    rank[v] = std::lower_bound(priorities.begin(), priorities.end(), pg[v].prio) - priorities.begin();
+  return rank;
+}
+
+/// \brief Number of distinct elements of values.
+inline
+size_t count_distinct(std::vector<priority_t> values)
+{
+  std::sort(values.begin(), values.end());
+  return std::unique(values.begin(), values.end()) - values.begin();
+}
+
+} // namespace detail
+
+/* \brief Merge runs of consecutive priorities of the same parity, and
+ *        number the runs densely.
+ *
+ * The order of priorities is preserved (but not strictly), as is their
+ * parity. For example, priorities 2, 4, 7, 9, 12 become 0, 0, 1, 1, 2.
+ */
+inline
+priority_compression_t renumber_priorities(parity_game_t& pg)
+{
+  cpplog(cpplogging::verbose) << "Renumbering priorities" << std::endl;
+  const std::vector<priority_t> priorities = distinct_priorities(pg);
+  priority_compression_t result;
+  result.before = priorities.size();
+  if(priorities.empty())
+    return result;
+
+  std::vector<priority_t> f(priorities.size());
+  f[0] = priorities[0] % 2;
+  for(size_t r = 1; r < priorities.size(); ++r)
+    f[r] = f[r-1] + ((priorities[r] % 2 == priorities[r-1] % 2) ? 0 : 1);
+
+  const std::vector<size_t> rank = detail::priority_ranks(pg, priorities);
+  for(size_t v = 0; v < rank.size(); ++v)
+    pg[v].prio = f[rank[v]];
+  result.after = f.back() - f.front() + 1;
+  return result;
+}
+
+/* \brief Friedmann-Lange priority compression.
+ *
+ * Only the priorities that occur infinitely often on a play determine its
+ * winner, and those all occur in a single non-trivial SCC. Vertices that are
+ * not on a cycle therefore get priority 0 or 1, depending on their parity.
+ * For the other vertices, the new priorities are the smallest ones that
+ * preserve parity, and within every SCC the order of priorities: if p < q
+ * are consecutive priorities within some SCC, then f(p) <= f(q), with
+ * f(p) < f(q) if p and q have different parity.
+ */
+inline
+priority_compression_t compress_priorities(parity_game_t& pg)
+{
+  cpplog(cpplogging::verbose) << "Compressing priorities" << std::endl;
+  const size_t n = boost::num_vertices(pg);
+  const std::vector<priority_t> priorities = distinct_priorities(pg);
+  priority_compression_t result;
+  result.before = priorities.size();
+  if(priorities.empty())
+    return result;
+
+  std::vector<size_t> component;
+  const size_t ncomponents = scc_decomposition(pg, component);
+  std::vector<size_t> component_size(ncomponents, 0);
+  for(size_t v = 0; v < n; ++v)
+    ++component_size[component[v]];
+  std::vector<bool> on_cycle(n);
+  for(size_t v = 0; v < n; ++v)
+    on_cycle[v] = component_size[component[v]] > 1 || boost::edge(v, v, pg).second;
+
+  // Group the ranks of the vertices on cycles by component, and derive the
+  // constraints between consecutive ranks within a component.
+  const std::vector<size_t> rank = detail::priority_ranks(pg, priorities);
+  std::vector<std::pair<size_t, size_t> > component_ranks;
+  for(size_t v = 0; v < n; ++v)
+  {
+    if(on_cycle[v])
+      component_ranks.push_back(std::make_pair(component[v], rank[v]));
+  }
+  std::sort(component_ranks.begin(), component_ranks.end());
+  component_ranks.erase(std::unique(component_ranks.begin(), component_ranks.end()), component_ranks.end());
+
+  std::vector<std::pair<size_t, size_t> > constraints; // (q, p): f(p) <= f(q)
+  for(size_t i = 1; i < component_ranks.size(); ++i)
+  {
+    if(component_ranks[i].first == component_ranks[i-1].first)
+      constraints.push_back(std::make_pair(component_ranks[i].second, component_ranks[i-1].second));
+  }
+  std::sort(constraints.begin(), constraints.end());
+
+  // Constraints only point from smaller to larger ranks, so the ranks are
+  // assigned in increasing order.
+  std::vector<priority_t> f(priorities.size());
+  std::vector<std::pair<size_t, size_t> >::const_iterator c = constraints.begin();
+  for(size_t r = 0; r < priorities.size(); ++r)
+  {
+    f[r] = priorities[r] % 2;
+    for(; c != constraints.end() && c->first == r; ++c)
+    {
+      const size_t p = c->second;
+      f[r] = std::max(f[r], f[p] + ((priorities[p] % 2 == priorities[r] % 2) ? 0 : 1));
+    }
+  }
+
+  std::vector<priority_t> assigned(n);
+  for(size_t v = 0; v < n; ++v)
+  {
+    assigned[v] = on_cycle[v] ? f[rank[v]] : pg[v].prio % 2;
+    pg[v].prio = assigned[v];
+  }
+  result.after = detail::count_distinct(assigned);
+  return result;
+}
+
+#endif // PRIORITY_COMPRESSION_H
@@ -12,16 +12,29 @@
 #ifndef REPORT_H
 #define REPORT_H
 
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
 #include "bfs.h"
 #include "degree.h"
+#include "priority_compression.h"
+#include "graph_statistics.h"
 #include "dfs.h"
 #include "diameter.h"
 #include "diamond.h"
+#include "motif.h"
 #include "girth.h"
+#include "sweep.h"
+#include "parity_girth.h"
 #include "neighbourhood.h"
+#include "hyperanf.h"
 #include "scc.h"
+#include "attractor.h"
+#include "zielonka.h"
 #include "alternation_depth.h"
 #include "treewidth.h"
+#include "tree_decomposition.h"
 #include "kellywidth.h"
 
 struct report_options
@@ -31,16 +44,29 @@ struct report_options
   bool dfs_info;
   bool diameter;
   bool girth;
+  bool parity_girth;
   bool diamonds;
+  bool motifs;
   bool neighbourhoods;
   size_t neighbourhoods_upto;
+  bool approximate_neighbourhoods;
+  size_t approximate_neighbourhoods_upto;
+  size_t hyperloglog_precision;
   bool treewidth_lowerbound;
   bool treewidth_upperbound;
+  bool treewidth_exact; ///< exponential in the worst case, hence not part of all
+  bool treewidth_clique_separators; ///< split the treewidth computations into atoms
+  std::string treewidth_decomposition_file; ///< if not empty, write the best upper bound here in PACE .td format
+  size_t anytime_restarts; ///< maximal number of restarts of the anytime upper bounds; 0 disables them
   bool kellywidth_upperbound;
   bool sccs;
+  bool attractors;
+  bool zielonka; ///< exponential in the worst case, hence not part of all
   bool alternation_depth_cks;
   bool alternation_depth;
+  bool alternation_depth_nested;
   size_t max_vertices_for_expensive_checks;
+  double budget_seconds; ///< time limit per budgeted measure; 0 means unlimited
 
   report_options(bool all=false)
     : general_graph_info(all),
@@ -48,62 +74,138 @@ struct report_options
       dfs_info(all),
       diameter(all),
       girth(all),
+      parity_girth(all),
       diamonds(all),
+      motifs(all),
       neighbourhoods(all),
       neighbourhoods_upto(3),
+      approximate_neighbourhoods(false),
+      approximate_neighbourhoods_upto(20),
+      hyperloglog_precision(6),
       treewidth_lowerbound(all),
       treewidth_upperbound(all),
+      treewidth_exact(false),
+      treewidth_clique_separators(all),
+      anytime_restarts(0),
       kellywidth_upperbound(all),
+      sccs(all),
+      attractors(all),
+      zielonka(false),
       alternation_depth_cks(all),
       alternation_depth(all),
-      max_vertices_for_expensive_checks(std::numeric_limits<size_t>::max())
+      alternation_depth_nested(all),
+      max_vertices_for_expensive_checks(std::numeric_limits<size_t>::max()),
+      budget_seconds(0)
   {}
 };
 
+namespace detail
+{
+
+/// \brief Emit the best width, the number of restarts and the time at
+///        which the best width was found.
+inline
+void report_anytime(const std::string& key, const anytime_upper_bound_t& bound, YAML::Emitter& out)
+{
+  out << YAML::Key << key
+      << YAML::Value
+      << YAML::BeginMap
+      << YAML::Key << "Upper bound" << YAML::Value << bound.width
+      << YAML::Key << "Restarts" << YAML::Value << bound.restarts
+      << YAML::Key << "Time to best" << YAML::Value << bound.time_to_best
+      << YAML::EndMap;
+}
+
+/// \brief Emit minimum, maximum, average and the non-empty entries of the
+///        histogram of a degree distribution.
+inline
+void report_degrees(const degree_statistics_t& degrees, double avg, YAML::Emitter& out)
+{
+  out << YAML::BeginMap
+      << YAML::Key << "min" << YAML::Value << degrees.min
+      << YAML::Key << "max" << YAML::Value << degrees.max
+      << YAML::Key << "avg" << YAML::Value << avg
+      << YAML::Key << "Histogram"
+      << YAML::Value << YAML::BeginMap;
+  for(size_t d = 0; d < degrees.histogram.size(); ++d)
+  {
+    if(degrees.histogram[d] > 0)
+      out << YAML::Key << d << YAML::Value << degrees.histogram[d];
+  }
+  out << YAML::EndMap
+      << YAML::EndMap;
+}
+
+/// \brief Emit the non-empty entries of histogram as a map under key.
 inline
-void report(const parity_game_t& pg, YAML::Emitter& out, const report_options options = report_options())
+void report_histogram(const std::string& key, const std::vector<size_t>& histogram, YAML::Emitter& out)
+{
+  out << YAML::Key << key
+      << YAML::Value << YAML::BeginMap;
+  for(size_t i = 0; i < histogram.size(); ++i)
+  {
+    if(histogram[i] > 0)
+      out << YAML::Key << i << YAML::Value << histogram[i];
+  }
+  out << YAML::EndMap;
+}
+
+} // namespace detail
+
+/* \brief Report the measures selected in options for pg.
+ *
+ * If pg was obtained by priority compression, compression holds the number
+ * of priorities before and after, which are then included in the report.
+ */
+inline
+void report(const parity_game_t& pg, YAML::Emitter& out, const report_options options = report_options(),
+            const priority_compression_t* compression = 0)
 {
   typedef typename boost::graph_traits<parity_game_t>::vertices_size_type vertex_size_t;
 
   out << YAML::BeginMap;
 
+  if(compression != 0)
+  {
+    out << YAML::Key << "Priority compression"
+        << YAML::Value
+        << YAML::BeginMap
+        << YAML::Key << "Priorities before" << YAML::Value << compression->before
+        << YAML::Key << "Priorities after" << YAML::Value << compression->after
+        << YAML::EndMap;
+  }
+
   if(options.general_graph_info)
   {
+    graph_statistics_t stats = graph_statistics(pg);
     out << YAML::Key << "Graph"
         << YAML::Value
         << YAML::BeginMap
           << YAML::Key << "Number of vertices"
-          << YAML::Value << boost::num_vertices(pg)
+          << YAML::Value << stats.vertices
           << YAML::Key << "Number of edges"
-          << YAML::Value << boost::num_edges(pg)
+          << YAML::Value << stats.edges
           << YAML::Key << "Number of even vertices"
-          << YAML::Value << num_even_vertices(pg)
+          << YAML::Value << stats.even_vertices
           << YAML::Key << "Number of odd vertices"
-          << YAML::Value << num_odd_vertices(pg)
+          << YAML::Value << stats.odd_vertices
           << YAML::Key << "Number of priorities"
-          << YAML::Value << priorities(pg).size()
+          << YAML::Value << stats.priorities.size()
+          << YAML::Key << "Vertices per priority"
+          << YAML::Value << YAML::BeginMap;
+    for(const std::pair<priority_t, size_t>& p: stats.priorities)
+      out << YAML::Key << p.first << YAML::Value << p.second;
+    out << YAML::EndMap
           << YAML::Key << "Degree"
-             << YAML::Value
-             << YAML::BeginMap
-             << YAML::Key << "min" << YAML::Value << min_degree(pg)
-             << YAML::Key << "max" << YAML::Value << max_degree(pg)
-             << YAML::Key << "avg" << YAML::Value << avg_degree(pg)
-             << YAML::EndMap
-          << YAML::Key << "In-degree"
-             << YAML::Value
-             << YAML::BeginMap
-             << YAML::Key << "min" << YAML::Value << min_in_degree(pg)
-             << YAML::Key << "max" << YAML::Value << max_in_degree(pg)
-             << YAML::Key << "avg" << YAML::Value << avg_in_degree(pg)
-             << YAML::EndMap
-          << YAML::Key << "Out-degree"
-             << YAML::Value
-             << YAML::BeginMap
-             << YAML::Key << "min" << YAML::Value << min_out_degree(pg)
-             << YAML::Key << "max" << YAML::Value << max_out_degree(pg)
-             << YAML::Key << "avg" << YAML::Value << avg_out_degree(pg)
-             << YAML::EndMap
-        << YAML::EndMap;
+          << YAML::Value;
+    detail::report_degrees(stats.degree, static_cast<double>(stats.edges)/static_cast<double>(stats.vertices), out);
+    out << YAML::Key << "In-degree"
+        << YAML::Value;
+    detail::report_degrees(stats.in_degree, static_cast<double>(stats.in_degree.sum)/static_cast<double>(stats.vertices), out);
+    out << YAML::Key << "Out-degree"
+        << YAML::Value;
+    detail::report_degrees(stats.out_degree, static_cast<double>(stats.out_degree.sum)/static_cast<double>(stats.vertices), out);
+    out << YAML::EndMap;
   }
 
   if(options.bfs_info)
@@ -166,16 +268,43 @@ void report(const parity_game_t& pg, YAML::Emitter& out, const report_options op
 
   }
 
+  // Diameter, girth and neighbourhoods share a single BFS from every vertex.
+  // Neighbourhoods on their own are cheaper using
+  // accumulated_upto_kneighbourhood.
+  sweep_result sweep;
+  if(options.diameter || options.girth)
+  {
+    sweep_options s;
+    s.diameter = options.diameter;
+    s.girth = options.girth;
+    s.neighbourhoods = options.neighbourhoods;
+    s.neighbourhoods_upto = options.neighbourhoods_upto;
+    sweep = all_sources_sweep(pg, s);
+  }
+
   if(options.diameter)
   {
     out << YAML::Key << "Diameter"
-        << YAML::Value << std::to_string(diameter(pg));
+        << YAML::Value << std::to_string(sweep.diameter);
   }
 
   if(options.girth)
   {
     out << YAML::Key << "Girth"
-        << YAML::Value << std::to_string(girth(pg));
+        << YAML::Value << std::to_string(sweep.girth);
+  }
+
+  if(options.parity_girth)
+  {
+    parity_girth_t girths = parity_girth(pg);
+    out << YAML::Key << "Parity girth"
+        << YAML::Value
+        << YAML::BeginMap
+        << YAML::Key << "Even"
+        << YAML::Value << std::to_string(girths.even)
+        << YAML::Key << "Odd"
+        << YAML::Value << std::to_string(girths.odd)
+        << YAML::EndMap;
   }
 
   if(options.diamonds)
@@ -193,9 +322,33 @@ void report(const parity_game_t& pg, YAML::Emitter& out, const report_options op
         << YAML::EndMap;
   }
 
+  if(options.motifs)
+  {
+    std::vector<motif_pattern> patterns = default_motifs();
+    std::vector<motif_count_t> counts = motif_census(pg, patterns);
+    out << YAML::Key << "Motifs"
+        << YAML::Value
+        << YAML::BeginMap;
+    for(size_t i = 0; i < patterns.size(); ++i)
+    {
+      out << YAML::Key << to_string(patterns[i])
+          << YAML::Value
+          << YAML::BeginMap
+          << YAML::Key << "Total" << YAML::Value << counts[i].all
+          << YAML::Key << "Even" << YAML::Value << counts[i].even
+          << YAML::Key << "Odd" << YAML::Value << counts[i].odd
+          << YAML::Key << "Even priorities" << YAML::Value << counts[i].even_priority
+          << YAML::Key << "Odd priorities" << YAML::Value << counts[i].odd_priority
+          << YAML::EndMap;
+    }
+    out << YAML::EndMap;
+  }
+
   if(options.neighbourhoods)
   {
-    std::vector<neighbourhood_result> neighbourhoods = accumulated_upto_kneighbourhood(pg, options.neighbourhoods_upto);
+    std::vector<neighbourhood_result> neighbourhoods = sweep.neighbourhoods;
+    if(neighbourhoods.empty())
+      neighbourhoods = accumulated_upto_kneighbourhood(pg, options.neighbourhoods_upto);
     out << YAML::Key << "Neighbourhood"
         << YAML::Value
         << YAML::BeginMap;
@@ -212,20 +365,120 @@ void report(const parity_game_t& pg, YAML::Emitter& out, const report_options op
     out << YAML::EndMap;
   }
 
-  if(options.treewidth_lowerbound || options.treewidth_upperbound)
+  if(options.approximate_neighbourhoods)
   {
-    undirected_parity_game_t undirected_pg;
-    boost::copy_graph(pg, undirected_pg);
+    std::vector<approximate_neighbourhood_result> neighbourhoods =
+      approximate_upto_kneighbourhood(pg, options.approximate_neighbourhoods_upto, options.hyperloglog_precision);
+    out << YAML::Key << "Approximate neighbourhood"
+        << YAML::Value
+        << YAML::BeginMap
+        << YAML::Key << "Relative standard error"
+        << YAML::Value << hyperloglog_relative_error(options.hyperloglog_precision);
+    for(size_t i = 1; i <= options.approximate_neighbourhoods_upto; ++i)
+    {
+      out << YAML::Key << i
+          << YAML::Value
+          << YAML::BeginMap
+          << YAML::Key << "min" << YAML::Value << neighbourhoods[i].min
+          << YAML::Key << "max" << YAML::Value << neighbourhoods[i].max
+          << YAML::Key << "avg" << YAML::Value << neighbourhoods[i].avg
+          << YAML::EndMap;
+    }
+    out << YAML::EndMap;
+  }
 
+  // The treewidth measures work on the underlying undirected graph, which
+  // they share, together with its reduction by the safe rules.
+  if(options.treewidth_lowerbound || options.treewidth_upperbound || options.treewidth_exact)
+  {
+    const treewidth_reduction reduction(pg);
+    if(options.treewidth_lowerbound || options.treewidth_upperbound)
+    {
+      const treewidth_kernel_t kernel = reduction.statistics();
+      out << YAML::Key << "Treewidth kernel"
+          << YAML::Value
+          << YAML::BeginMap
+          << YAML::Key << "Vertices" << YAML::Value << kernel.vertices
+          << YAML::Key << "Edges" << YAML::Value << kernel.edges
+          << YAML::Key << "Lower bound" << YAML::Value << kernel.lower_bound
+          << YAML::EndMap;
+    }
     if(options.treewidth_lowerbound)
     {
+      const bool expensive = boost::num_vertices(pg) <= options.max_vertices_for_expensive_checks;
+      budget b(options.budget_seconds);
+      std::vector<treewidth_lower_bound_t> bounds = treewidth_lower_bounds(reduction, expensive, &b, options.treewidth_clique_separators);
+      const treewidth_lower_bound_t& best = best_lower_bound(bounds);
       out << YAML::Key << "Treewidth (Lower bound)"
-          << YAML::Value << minor_min_width(undirected_pg);
+          << YAML::Value << best.width
+          << YAML::Key << "Treewidth lower bound method"
+          << YAML::Value << best.method
+          << YAML::Key << "Treewidth lower bounds"
+          << YAML::Value << YAML::BeginMap;
+      for(const treewidth_lower_bound_t& bound: bounds)
+        out << YAML::Key << bound.method << YAML::Value << bound.width;
+      out << YAML::EndMap;
+      std::vector<std::string> incomplete;
+      for(const treewidth_lower_bound_t& bound: bounds)
+      {
+        if(!bound.complete)
+          incomplete.push_back(bound.method);
+      }
+      if(!incomplete.empty())
+        out << YAML::Key << "Treewidth lower bounds incomplete" << YAML::Value << YAML::Flow << incomplete;
     }
     if(options.treewidth_upperbound)
     {
+      const bool expensive = boost::num_vertices(pg) <= options.max_vertices_for_expensive_checks;
+      std::vector<treewidth_upper_bound_t> bounds = treewidth_upper_bounds(reduction, expensive, options.treewidth_clique_separators);
       out << YAML::Key << "Treewidth (Upper bound)"
-          << YAML::Value << greedy_degree(undirected_pg);
+          << YAML::Value << best_upper_bound(bounds).width
+          << YAML::Key << "Treewidth upper bounds"
+          << YAML::Value << YAML::BeginMap;
+      for(const treewidth_upper_bound_t& bound: bounds)
+        out << YAML::Key << bound.method << YAML::Value << bound.width;
+      out << YAML::EndMap;
+
+      if(!options.treewidth_decomposition_file.empty())
+      {
+        const treewidth_upper_bound_t& best = best_upper_bound(bounds);
+        const tree_decomposition_t td = tree_decomposition(pg, best.ordering);
+        std::ofstream os(options.treewidth_decomposition_file.c_str());
+        if(!os)
+          throw std::runtime_error("cannot open " + options.treewidth_decomposition_file + " for writing");
+        print_pace_td(td, boost::num_vertices(pg), os, best.ordering);
+        out << YAML::Key << "Treewidth decomposition"
+            << YAML::Value
+            << YAML::BeginMap
+            << YAML::Key << "File" << YAML::Value << options.treewidth_decomposition_file
+            << YAML::Key << "Bags" << YAML::Value << td.bags.size()
+            << YAML::Key << "Width" << YAML::Value << td.width()
+            << YAML::Key << "Valid" << YAML::Value << is_tree_decomposition(pg, td)
+            << YAML::EndMap;
+      }
+
+      if(options.anytime_restarts > 0)
+      {
+        // Start from the best bound above, including its clique separators,
+        // so that the budget only covers the restarts.
+        budget b(options.budget_seconds, options.anytime_restarts);
+        detail::report_anytime("Treewidth (Anytime)",
+            anytime_treewidth_upper_bound(reduction, best_upper_bound(bounds), b, expensive), out);
+      }
+    }
+
+    if(options.treewidth_exact)
+    {
+      budget b(options.budget_seconds);
+      exact_treewidth_t exact = exact_treewidth(reduction, b);
+      out << YAML::Key << "Treewidth (Exact)"
+          << YAML::Value
+          << YAML::BeginMap
+          << YAML::Key << "Complete" << YAML::Value << exact.complete
+          << YAML::Key << "Lower bound" << YAML::Value << exact.lower_bound
+          << YAML::Key << "Upper bound" << YAML::Value << exact.upper_bound
+          << YAML::Key << "Search nodes" << YAML::Value << exact.nodes
+          << YAML::EndMap;
     }
   }
 
@@ -233,31 +486,98 @@ void report(const parity_game_t& pg, YAML::Emitter& out, const report_options op
   {
     out << YAML::Key << "Kelly-width (Upper bound)"
         << YAML::Value << elimination_ordering(pg);
+    if(options.anytime_restarts > 0)
+    {
+      budget b(options.budget_seconds, options.anytime_restarts);
+      detail::report_anytime("Kelly-width (Anytime)", anytime_kellywidth_upper_bound(pg, b), out);
+    }
   }
 
   if(options.sccs)
   {
     cpplog(cpplogging::verbose) << "Computing SCCs" << std::endl;
-    std::vector<vertex_size_t> sccs (boost::num_vertices(pg), 0);
-    vertex_size_t nsccs = boost::strong_components(pg, &sccs[0]);
-    parity_game_t quotient = quotient_graph(pg, sccs, nsccs);
+    scc_statistics_t stats = scc_statistics(pg);
     out << YAML::Key << "SCC"
         << YAML::Value
         << YAML::BeginMap
-        << YAML::Key << "SCCs" << YAML::Value << nsccs
-        << YAML::Key << "Trivial SCCs" << YAML::Value << count_elements_occurring_exactly_n_times(sccs, 1)
-        << YAML::Key << "Terminal SCCs" << YAML::Value << vertices_out_degree_n(quotient, 0)
-        << YAML::Key << "Quotient height" << YAML::Value << bfs_levels(quotient)
+        << YAML::Key << "SCCs" << YAML::Value << stats.sccs
+        << YAML::Key << "Trivial SCCs" << YAML::Value << stats.trivial_sccs
+        << YAML::Key << "Terminal SCCs" << YAML::Value << stats.terminal_sccs
+        << YAML::Key << "Quotient height" << YAML::Value << stats.quotient_height
+        << YAML::Key << "DAG depth" << YAML::Value << stats.dag_depth
+        << YAML::Key << "Largest SCC" << YAML::Value << stats.largest_scc
+        << YAML::Key << "Largest SCC fraction" << YAML::Value << stats.largest_scc_fraction
+        << YAML::Key << "SCC sizes"
+        << YAML::Value << YAML::BeginMap;
+    for(const std::pair<size_t, size_t>& p: stats.sizes)
+      out << YAML::Key << p.first << YAML::Value << p.second;
+    out << YAML::EndMap
         << YAML::EndMap;
   }
 
-  if(options.alternation_depth_cks)
+  if(options.attractors)
+  {
+    std::vector<attractor_statistics_t> attractors = top_priority_attractors(pg);
+    out << YAML::Key << "Top priority attractors"
+        << YAML::Value
+        << YAML::BeginMap;
+    for(size_t alpha = 0; alpha < 2; ++alpha)
+    {
+      if(!attractors[alpha].exists)
+        continue;
+      out << YAML::Key << (alpha == even ? "Even" : "Odd")
+          << YAML::Value
+          << YAML::BeginMap
+          << YAML::Key << "Priority" << YAML::Value << attractors[alpha].top_priority
+          << YAML::Key << "Size" << YAML::Value << attractors[alpha].size
+          << YAML::Key << "Depth" << YAML::Value << attractors[alpha].depth
+          << YAML::EndMap;
+    }
+    out << YAML::EndMap;
+  }
+
+  if(options.zielonka)
   {
-    out << YAML::Key << "Alternation depth [CKS93]" << YAML::Value << alternation_depth(pg);
+    budget b(options.budget_seconds);
+    zielonka_profile_t profile = zielonka_profile(pg, b);
+    out << YAML::Key << "Zielonka"
+        << YAML::Value
+        << YAML::BeginMap
+        << YAML::Key << "Complete" << YAML::Value << profile.complete
+        << YAML::Key << "Recursive calls" << YAML::Value << profile.recursive_calls
+        << YAML::Key << "Max depth" << YAML::Value << profile.max_depth
+        << YAML::Key << "Attractor computations" << YAML::Value << profile.attractors;
+    if(profile.complete)
+    {
+      out << YAML::Key << "Winning even" << YAML::Value << profile.winning[even]
+          << YAML::Key << "Winning odd" << YAML::Value << profile.winning[odd];
+    }
+    out << YAML::EndMap;
+  }
+
+  if(options.alternation_depth_cks || options.alternation_depth)
+  {
+    cpplog(cpplogging::verbose) << "Computing alternation depth" << std::endl;
+    const csr_graph fwd = make_csr(pg);
+    const csr_graph bwd = make_reverse_csr(fwd);
+    std::vector<size_t> components;
+    const size_t sccs = scc_decomposition(fwd, bwd, components);
+    if(options.alternation_depth_cks)
+    {
+      alternation_depth_statistics_t ad = alternation_depth_statistics(pg, bwd, components, sccs, vertex_index_ordering);
+      out << YAML::Key << "Alternation depth [CKS93]" << YAML::Value << ad.depth;
+      detail::report_histogram("SCCs per alternation depth [CKS93]", ad.histogram, out);
+    }
+    if(options.alternation_depth)
+    {
+      alternation_depth_statistics_t ad = alternation_depth_statistics(pg, bwd, components, sccs, priority_ordering);
+      out << YAML::Key << "Alternation depth (priority ordering)" << YAML::Value << ad.depth;
+      detail::report_histogram("SCCs per alternation depth (priority ordering)", ad.histogram, out);
+    }
   }
-  if(options.alternation_depth)
+  if(options.alternation_depth_nested)
   {
-    out << YAML::Key << "Alternation depth (priority ordering)" << YAML::Value << alternation_depth_priority_sorting(pg);
+    out << YAML::Key << "Alternation depth (nested)" << YAML::Value << nested_alternation_depth(pg);
   }
 
   out << YAML::EndMap;
@@ -12,25 +12,78 @@
 #ifndef SCC_INFO_H
 #define SCC_INFO_H
 
-#include <boost/graph/strong_components.hpp>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
 #include "cpplogging/logger.h"
 #include "bfs.h"
+#include "csr.h"
 #include "degree.h"
+#include "scc_decomposition.h"
+#include "utilities.h"
 
-template<typename Graph, typename ComponentMap>
+/* \brief The graph of SCCs of the graph with successors fwd.
+ *
+ * Component c has an edge to component d != c if some vertex in c has an
+ * edge to some vertex in d. The inter-component edges are bucketed by the
+ * component of their source, after which every bucket is sorted and
+ * duplicates are removed.
+ */
 inline
-Graph quotient_graph(const Graph& g, ComponentMap m, const size_t num_components)
+csr_graph condensation(const csr_graph& fwd, const std::vector<size_t>& component, const size_t num_components)
 {
-  /* Fix quotient graph such that vertex 0 is in component 0 */
-  size_t comp_zero = m[0];
-  for(auto i = m.begin(); i != m.end(); ++i)
+  cpplog(cpplogging::verbose) << "Computing condensation" << std::endl;
+  const size_t n = fwd.num_vertices();
+  std::vector<size_t> offsets(num_components + 1, 0);
+  for(size_t v = 0; v < n; ++v)
+  {
+    for(const csr_vertex_t* w = fwd.begin(v); w != fwd.end(v); ++w)
+    {
+      if(component[v] != component[*w])
+        ++offsets[component[v] + 1];
+    }
+  }
+  for(size_t c = 0; c < num_components; ++c)
+    offsets[c + 1] += offsets[c];
+
+  std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+  std::vector<csr_vertex_t> targets(offsets.back());
+  for(size_t v = 0; v < n; ++v)
+  {
+    for(const csr_vertex_t* w = fwd.begin(v); w != fwd.end(v); ++w)
+    {
+      if(component[v] != component[*w])
+        targets[position[component[v]]++] = static_cast<csr_vertex_t>(component[*w]);
+    }
+  }
+
+  // Sort and deduplicate every bucket, compacting the targets in place.
+  size_t out = 0;
+  size_t first = 0;
+  for(size_t c = 0; c < num_components; ++c)
   {
-    if(*i == 0)
-      *i = comp_zero;
-    else if(*i == comp_zero)
-      *i = 0;
+    const size_t last = offsets[c + 1];
+    std::sort(targets.begin() + first, targets.begin() + last);
+    const size_t begin = out;
+    for(size_t i = first; i < last; ++i)
+    {
+      if(out == begin || targets[out - 1] != targets[i])
+        targets[out++] = targets[i];
+    }
+    first = last;
+    offsets[c + 1] = out;
   }
+  targets.resize(out);
+  return csr_graph(std::move(offsets), std::move(targets));
+}
 
+/// \brief The quotient of g with respect to the component map m, as a graph
+///        of the same type as g.
+template<typename Graph, typename ComponentMap>
+inline
+Graph quotient_graph(const Graph& g, const ComponentMap& m, const size_t num_components)
+{
   Graph result;
   for(size_t i = 0; i < num_components; ++i)
     boost::add_vertex(result);
@@ -45,15 +98,130 @@ Graph quotient_graph(const Graph& g, ComponentMap m, const size_t num_components
   return result;
 }
 
+namespace detail
+{
+
+/// \brief Number of BFS levels in g from root.
+inline
+size_t csr_bfs_levels(const csr_graph& g, size_t root)
+{
+  std::vector<size_t> level(g.num_vertices(), std::numeric_limits<size_t>::max());
+  std::vector<csr_vertex_t> queue(1, static_cast<csr_vertex_t>(root));
+  level[root] = 0;
+  size_t result = 0;
+  for(size_t i = 0; i < queue.size(); ++i)
+  {
+    const csr_vertex_t v = queue[i];
+    result = level[v] + 1;
+    for(const csr_vertex_t* w = g.begin(v); w != g.end(v); ++w)
+    {
+      if(level[*w] == std::numeric_limits<size_t>::max())
+      {
+        level[*w] = level[v] + 1;
+        queue.push_back(*w);
+      }
+    }
+  }
+  return result;
+}
+
+/// \brief Number of vertices on a longest path in the acyclic graph g,
+///        using Kahn's topological sort.
+inline
+size_t dag_depth(const csr_graph& g)
+{
+  const size_t n = g.num_vertices();
+  std::vector<size_t> in(n, 0);
+  for(csr_vertex_t w: g.targets())
+    ++in[w];
+  std::vector<csr_vertex_t> queue;
+  for(size_t v = 0; v < n; ++v)
+  {
+    if(in[v] == 0)
+      queue.push_back(static_cast<csr_vertex_t>(v));
+  }
+
+  std::vector<size_t> depth(n, 1);
+  size_t result = 0;
+  for(size_t i = 0; i < queue.size(); ++i)
+  {
+    const csr_vertex_t v = queue[i];
+    result = std::max(result, depth[v]);
+    for(const csr_vertex_t* w = g.begin(v); w != g.end(v); ++w)
+    {
+      depth[*w] = std::max(depth[*w], depth[v] + 1);
+      if(--in[*w] == 0)
+        queue.push_back(*w);
+    }
+  }
+  assert(queue.size() == n);
+  return result;
+}
+
+} // namespace detail
+
+struct scc_statistics_t
+{
+  size_t sccs;
+  size_t trivial_sccs;     ///< SCCs consisting of a single vertex.
+  size_t terminal_sccs;    ///< SCCs without outgoing edges.
+  size_t largest_scc;      ///< Number of vertices in the largest SCC.
+  double largest_scc_fraction; ///< largest_scc divided by the number of vertices.
+  size_t quotient_height;  ///< Number of BFS levels in the condensation from the SCC of vertex 0.
+  size_t dag_depth;        ///< Number of SCCs on a longest path in the condensation.
+  std::vector<std::pair<size_t, size_t> > sizes; ///< Number of SCCs per size, by increasing size.
+
+  scc_statistics_t()
+    : sccs(0), trivial_sccs(0), terminal_sccs(0), largest_scc(0),
+      largest_scc_fraction(0), quotient_height(0), dag_depth(0)
+  {}
+};
+
+/// \brief Statistics of the SCCs of g and of its condensation.
+template<typename Graph>
+inline
+scc_statistics_t scc_statistics(const Graph& g)
+{
+  const csr_graph fwd = make_csr(g);
+  std::vector<size_t> component;
+  scc_statistics_t result;
+  result.sccs = scc_decomposition(fwd, make_reverse_csr(fwd), component);
+  if(result.sccs == 0)
+    return result;
+
+  std::vector<size_t> size(result.sccs, 0);
+  for(size_t c: component)
+    ++size[c];
+  result.largest_scc = *std::max_element(size.begin(), size.end());
+  result.largest_scc_fraction = static_cast<double>(result.largest_scc)/static_cast<double>(component.size());
+
+  std::vector<size_t> count(result.largest_scc + 1, 0);
+  for(size_t s: size)
+    ++count[s];
+  for(size_t s = 1; s < count.size(); ++s)
+  {
+    if(count[s] > 0)
+      result.sizes.push_back(std::make_pair(s, count[s]));
+  }
+  result.trivial_sccs = count[1];
+
+  const csr_graph quotient = condensation(fwd, component, result.sccs);
+  for(size_t c = 0; c < result.sccs; ++c)
+  {
+    if(quotient.degree(c) == 0)
+      ++result.terminal_sccs;
+  }
+  result.quotient_height = detail::csr_bfs_levels(quotient, component[0]);
+  result.dag_depth = detail::dag_depth(quotient);
+  return result;
+}
+
 template<typename Graph>
 inline
 typename boost::graph_traits<Graph>::vertices_size_type
 quotient_height(const Graph& g)
 {
-  typedef typename boost::graph_traits<Graph>::vertices_size_type vertex_size_t;
-  std::vector<vertex_size_t> components (boost::num_vertices(g), 0);
-  vertex_size_t ncomponents = boost::strong_components(g, &components[0]);
-  return bfs_levels(quotient_graph(g, components, ncomponents));
+  return scc_statistics(g).quotient_height;
 }
 
 template<typename Graph>
@@ -61,9 +229,8 @@ inline
 typename boost::graph_traits<Graph>::vertices_size_type
 sccs(const Graph& g)
 {
-  typedef typename boost::graph_traits<Graph>::vertices_size_type vertex_size_t;
-  std::vector<vertex_size_t> components (boost::num_vertices(g), 0);
-  return boost::strong_components(g, &components[0]);
+  std::vector<size_t> components;
+  return scc_decomposition(g, components);
 }
 
 template<typename Graph>
@@ -71,9 +238,8 @@ inline
 typename boost::graph_traits<Graph>::vertices_size_type
 trivial_sccs(const Graph& g)
 {
-  typedef typename boost::graph_traits<Graph>::vertices_size_type vertex_size_t;
-  std::vector<vertex_size_t> components (boost::num_vertices(g), 0);
-  boost::strong_components(g, &components[0]);
+  std::vector<size_t> components;
+  scc_decomposition(g, components);
   return count_elements_occurring_exactly_n_times(components);
 }
 
@@ -82,10 +248,7 @@ inline
 typename boost::graph_traits<Graph>::vertices_size_type
 terminal_sccs(const Graph& g)
 {
-  typedef typename boost::graph_traits<Graph>::vertices_size_type vertex_size_t;
-  std::vector<vertex_size_t> components (boost::num_vertices(g), 0);
-  vertex_size_t ncomponents = boost::strong_components(g, &components[0]);
-  return vertices_out_degree_n(quotient_graph(g, components, ncomponents));
+  return scc_statistics(g).terminal_sccs;
 }
 
 #endif // SCC_INFO_H
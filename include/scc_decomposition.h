@@ -0,0 +1,421 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file scc_decomposition.h
+/// \brief Parallel decomposition into strongly connected components.
+///
+/// The games we analyse typically consist of one giant SCC and many trivial
+/// SCCs. Following S. Hong, N.C. Rodia and K. Olukotun, "On Fast Parallel
+/// Detection of Strongly Connected Components (SCC) in Small-World Graphs",
+/// SC 2013, the decomposition proceeds in phases:
+///  1. trimming repeatedly removes vertices without live predecessors or
+///     successors, each of which is a trivial SCC;
+///  2. a single forward-backward search from a vertex of high degree finds
+///     the giant SCC;
+///  3. trimming is repeated on the remainder;
+///  4. colouring (S. Orzan, "On Distributed Verification and Verified
+///     Distribution", 2004) splits off SCCs in rounds of parallel
+///     propagation;
+///  5. once the remainder is small, or colouring makes little progress, it
+///     is decomposed by a sequential Tarjan search.
+/// All phases work on the frozen graph and its reverse.
+
+#ifndef SCC_DECOMPOSITION_H
+#define SCC_DECOMPOSITION_H
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "csr.h"
+#include "parallel.h"
+
+namespace detail
+{
+
+const size_t scc_unassigned = std::numeric_limits<size_t>::max();
+
+/// \brief Default number of remaining vertices below which SCCs are
+///        computed sequentially.
+const size_t scc_sequential_threshold = 65536;
+
+/// \brief Shared state of the phases of scc_decomposition.
+struct scc_state
+{
+  const csr_graph& fwd;
+  const csr_graph& bwd;
+  std::vector<size_t>& component;
+  std::atomic<size_t> next; ///< next free component number
+
+  scc_state(const csr_graph& f, const csr_graph& b, std::vector<size_t>& c)
+    : fwd(f), bwd(b), component(c), next(0)
+  {}
+
+  bool live(size_t v) const
+  {
+    return component[v] == scc_unassigned;
+  }
+
+  std::vector<csr_vertex_t> live_vertices() const
+  {
+    std::vector<csr_vertex_t> result;
+    for(size_t v = 0; v < component.size(); ++v)
+    {
+      if(live(v))
+        result.push_back(static_cast<csr_vertex_t>(v));
+    }
+    return result;
+  }
+};
+
+/// \brief Call f(v, thread, next) for all v in frontier in parallel, where
+///        next is a thread-local vector receiving the next frontier.
+template <typename Function>
+inline
+void expand_frontier(std::vector<csr_vertex_t>& frontier, std::vector<std::vector<csr_vertex_t> >& next, Function f)
+{
+  for(std::vector<csr_vertex_t>& local: next)
+    local.clear();
+  parallel_for(0, frontier.size(), [&](size_t i, size_t thread)
+  {
+    f(frontier[i], next[thread]);
+  }, 256);
+  frontier.clear();
+  for(const std::vector<csr_vertex_t>& local: next)
+    frontier.insert(frontier.end(), local.begin(), local.end());
+}
+
+/// \brief Number of live neighbours of v in g, not counting v itself.
+inline
+uint32_t live_degree(const scc_state& s, const csr_graph& g, size_t v)
+{
+  uint32_t result = 0;
+  for(const csr_vertex_t* w = g.begin(v); w != g.end(v); ++w)
+  {
+    if(*w != v && s.live(*w))
+      ++result;
+  }
+  return result;
+}
+
+/* \brief Repeatedly remove live vertices without live predecessors or
+ *        without live successors (ignoring self-loops); each of them is an
+ *        SCC on its own.
+ */
+inline
+void scc_trim(scc_state& s)
+{
+  const size_t n = s.component.size();
+  std::vector<std::atomic<uint32_t> > in(n);
+  std::vector<std::atomic<uint32_t> > out(n);
+  std::vector<std::atomic<char> > trimmed(n);
+  std::vector<std::vector<csr_vertex_t> > next(num_threads());
+  std::vector<csr_vertex_t> frontier;
+
+  parallel_for(0, n, [&](size_t v, size_t thread)
+  {
+    trimmed[v].store(0, std::memory_order_relaxed);
+    if(!s.live(v))
+      return;
+    in[v].store(live_degree(s, s.bwd, v), std::memory_order_relaxed);
+    out[v].store(live_degree(s, s.fwd, v), std::memory_order_relaxed);
+    if(in[v].load(std::memory_order_relaxed) == 0 || out[v].load(std::memory_order_relaxed) == 0)
+    {
+      trimmed[v].store(1, std::memory_order_relaxed);
+      next[thread].push_back(static_cast<csr_vertex_t>(v));
+    }
+  }, 1024);
+  for(const std::vector<csr_vertex_t>& local: next)
+    frontier.insert(frontier.end(), local.begin(), local.end());
+
+  while(!frontier.empty())
+  {
+    // Assign components first, so that liveness does not change while the
+    // counters of the neighbours are updated.
+    for(csr_vertex_t v: frontier)
+      s.component[v] = s.next++;
+    expand_frontier(frontier, next, [&](csr_vertex_t v, std::vector<csr_vertex_t>& local)
+    {
+      for(const csr_vertex_t* w = s.fwd.begin(v); w != s.fwd.end(v); ++w)
+      {
+        if(*w != v && s.live(*w) && --in[*w] == 0 && trimmed[*w].exchange(1) == 0)
+          local.push_back(*w);
+      }
+      for(const csr_vertex_t* w = s.bwd.begin(v); w != s.bwd.end(v); ++w)
+      {
+        if(*w != v && s.live(*w) && --out[*w] == 0 && trimmed[*w].exchange(1) == 0)
+          local.push_back(*w);
+      }
+    });
+  }
+}
+
+/// \brief Mark all live vertices reachable from root in g, and for which
+///        allowed holds, in visited; level-synchronous parallel BFS.
+template <typename Predicate>
+inline
+void scc_reach(const scc_state& s, const csr_graph& g, csr_vertex_t root, Predicate allowed,
+               std::vector<std::atomic<char> >& visited)
+{
+  std::vector<std::vector<csr_vertex_t> > next(num_threads());
+  std::vector<csr_vertex_t> frontier(1, root);
+  visited[root].store(1);
+  while(!frontier.empty())
+  {
+    expand_frontier(frontier, next, [&](csr_vertex_t v, std::vector<csr_vertex_t>& local)
+    {
+      for(const csr_vertex_t* w = g.begin(v); w != g.end(v); ++w)
+      {
+        if(s.live(*w) && allowed(*w) && visited[*w].load(std::memory_order_relaxed) == 0
+           && visited[*w].exchange(1) == 0)
+          local.push_back(*w);
+      }
+    });
+  }
+}
+
+/// \brief Find the SCC of a live vertex of maximal degree by a forward and
+///        a backward search.
+inline
+void scc_forward_backward(scc_state& s)
+{
+  const size_t n = s.component.size();
+  size_t pivot = n;
+  size_t best = 0;
+  for(size_t v = 0; v < n; ++v)
+  {
+    const size_t weight = (s.fwd.degree(v) + 1) * (s.bwd.degree(v) + 1);
+    if(s.live(v) && (pivot == n || weight > best))
+    {
+      pivot = v;
+      best = weight;
+    }
+  }
+  if(pivot == n)
+    return;
+
+  std::vector<std::atomic<char> > forward(n);
+  std::vector<std::atomic<char> > backward(n);
+  parallel_for(0, n, [&](size_t v, size_t)
+  {
+    forward[v].store(0, std::memory_order_relaxed);
+    backward[v].store(0, std::memory_order_relaxed);
+  }, 4096);
+
+  scc_reach(s, s.fwd, static_cast<csr_vertex_t>(pivot), [](csr_vertex_t) { return true; }, forward);
+  // Every vertex on a path from a vertex in the SCC back to the pivot is
+  // reachable from the pivot, so the backward search stays within forward.
+  scc_reach(s, s.bwd, static_cast<csr_vertex_t>(pivot),
+            [&](csr_vertex_t w) { return forward[w].load(std::memory_order_relaxed) != 0; }, backward);
+
+  const size_t c = s.next++;
+  parallel_for(0, n, [&](size_t v, size_t)
+  {
+    if(backward[v].load(std::memory_order_relaxed))
+      s.component[v] = c;
+  }, 4096);
+}
+
+/* \brief One round of colouring: propagate the maximal vertex number
+ *        forward until stable; every vertex whose colour is its own number
+ *        is the root of an SCC, consisting of the vertices of its colour
+ *        that reach it.
+ *
+ * \return the number of vertices that were assigned to an SCC.
+ */
+inline
+size_t scc_colour(scc_state& s, const std::vector<csr_vertex_t>& live)
+{
+  const size_t n = s.component.size();
+  std::vector<std::atomic<csr_vertex_t> > colour(n);
+  for(csr_vertex_t v: live)
+    colour[v].store(v, std::memory_order_relaxed);
+
+  std::atomic<bool> changed(true);
+  while(changed.load())
+  {
+    changed.store(false);
+    parallel_for(0, live.size(), [&](size_t i, size_t)
+    {
+      const csr_vertex_t v = live[i];
+      const csr_vertex_t c = colour[v].load(std::memory_order_relaxed);
+      for(const csr_vertex_t* w = s.fwd.begin(v); w != s.fwd.end(v); ++w)
+      {
+        if(!s.live(*w))
+          continue;
+        csr_vertex_t current = colour[*w].load(std::memory_order_relaxed);
+        while(c > current && !colour[*w].compare_exchange_weak(current, c))
+        {}
+        if(c > current)
+          changed.store(true, std::memory_order_relaxed);
+      }
+    }, 256);
+  }
+
+  std::vector<csr_vertex_t> roots;
+  for(csr_vertex_t v: live)
+  {
+    if(colour[v].load(std::memory_order_relaxed) == v)
+      roots.push_back(v);
+  }
+
+  // Roots have disjoint colours, so their backward searches are independent.
+  std::vector<std::vector<csr_vertex_t> > queues(num_threads());
+  std::vector<std::vector<csr_vertex_t> > members(roots.size());
+  parallel_for(0, roots.size(), [&](size_t i, size_t thread)
+  {
+    const csr_vertex_t root = roots[i];
+    std::vector<csr_vertex_t>& queue = queues[thread];
+    std::vector<csr_vertex_t>& scc = members[i];
+    queue.assign(1, root);
+    colour[root].store(n, std::memory_order_relaxed); // visited
+    while(!queue.empty())
+    {
+      const csr_vertex_t v = queue.back();
+      queue.pop_back();
+      scc.push_back(v);
+      for(const csr_vertex_t* w = s.bwd.begin(v); w != s.bwd.end(v); ++w)
+      {
+        if(s.live(*w) && colour[*w].load(std::memory_order_relaxed) == root)
+        {
+          colour[*w].store(n, std::memory_order_relaxed);
+          queue.push_back(*w);
+        }
+      }
+    }
+  }, 16);
+
+  size_t result = 0;
+  for(const std::vector<csr_vertex_t>& scc: members)
+  {
+    const size_t c = s.next++;
+    for(csr_vertex_t v: scc)
+      s.component[v] = c;
+    result += scc.size();
+  }
+  return result;
+}
+
+/// \brief Iterative Tarjan search on the live vertices.
+inline
+void scc_tarjan(scc_state& s)
+{
+  const size_t n = s.component.size();
+  const size_t unvisited = std::numeric_limits<size_t>::max();
+  std::vector<size_t> index(n, unvisited);
+  std::vector<size_t> lowlink(n, 0);
+  std::vector<csr_vertex_t> stack;
+  std::vector<std::pair<csr_vertex_t, const csr_vertex_t*> > call_stack;
+  size_t counter = 0;
+
+  for(size_t root = 0; root < n; ++root)
+  {
+    if(!s.live(root) || index[root] != unvisited)
+      continue;
+
+    index[root] = lowlink[root] = counter++;
+    stack.push_back(static_cast<csr_vertex_t>(root));
+    call_stack.push_back(std::make_pair(static_cast<csr_vertex_t>(root), s.fwd.begin(root)));
+    while(!call_stack.empty())
+    {
+      const csr_vertex_t v = call_stack.back().first;
+      const csr_vertex_t*& w = call_stack.back().second;
+      if(w != s.fwd.end(v))
+      {
+        const csr_vertex_t u = *w++;
+        if(!s.live(u))
+          continue;
+        if(index[u] == unvisited)
+        {
+          index[u] = lowlink[u] = counter++;
+          stack.push_back(u);
+          call_stack.push_back(std::make_pair(u, s.fwd.begin(u)));
+        }
+        else
+          lowlink[v] = std::min(lowlink[v], index[u]); // only vertices on the stack are live
+        continue;
+      }
+
+      call_stack.pop_back();
+      if(!call_stack.empty())
+        lowlink[call_stack.back().first] = std::min(lowlink[call_stack.back().first], lowlink[v]);
+      if(lowlink[v] == index[v])
+      {
+        const size_t c = s.next++;
+        csr_vertex_t u;
+        do
+        {
+          u = stack.back();
+          stack.pop_back();
+          s.component[u] = c;
+        } while(u != v);
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+/* \brief Decompose the graph with successors fwd and predecessors bwd into
+ *        SCCs.
+ *
+ * On return, component[v] in [0, result) is the number of the SCC of v, as
+ * for boost::strong_components. Components are numbered in order of their
+ * smallest vertex; in particular vertex 0 is in component 0.
+ *
+ * Rounds of colouring run while more than sequential_threshold vertices
+ * remain; the rest is left to Tarjan's algorithm.
+ */
+inline
+size_t scc_decomposition(const csr_graph& fwd, const csr_graph& bwd, std::vector<size_t>& component,
+                         size_t sequential_threshold = detail::scc_sequential_threshold)
+{
+  cpplog(cpplogging::verbose) << "Computing strongly connected components" << std::endl;
+  const size_t n = fwd.num_vertices();
+  component.assign(n, detail::scc_unassigned);
+  detail::scc_state s(fwd, bwd, component);
+
+  detail::scc_trim(s);
+  detail::scc_forward_backward(s);
+  detail::scc_trim(s);
+  std::vector<csr_vertex_t> live = s.live_vertices();
+  while(live.size() > sequential_threshold)
+  {
+    const size_t removed = detail::scc_colour(s, live);
+    live = s.live_vertices();
+    if(removed < live.size()/16)
+      break;
+  }
+  if(!live.empty())
+    detail::scc_tarjan(s);
+
+  const size_t result = s.next.load();
+  std::vector<size_t> renumber(result, detail::scc_unassigned);
+  size_t next = 0;
+  for(size_t v = 0; v < n; ++v)
+  {
+    if(renumber[component[v]] == detail::scc_unassigned)
+      renumber[component[v]] = next++;
+    component[v] = renumber[component[v]];
+  }
+  return result;
+}
+
+/// \brief Decompose g into SCCs; see scc_decomposition(const csr_graph&,
+///        const csr_graph&, std::vector<size_t>&).
+template <typename Graph>
+inline
+size_t scc_decomposition(const Graph& g, std::vector<size_t>& component,
+                         size_t sequential_threshold = detail::scc_sequential_threshold)
+{
+  const csr_graph fwd = make_csr(g);
+  return scc_decomposition(fwd, make_reverse_csr(fwd), component, sequential_threshold);
+}
+
+#endif // SCC_DECOMPOSITION_H
@@ -0,0 +1,257 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file separators.h
+/// \brief Splitting undirected graphs along separators that preserve
+///        treewidth.
+///
+/// If S is a clique separator of G, the treewidth of G is the maximum of the
+/// treewidths of the graphs induced by the components of G - S, each
+/// together with S. Single vertices are cliques, so this covers connected
+/// components (S empty) and biconnected components (S a cut vertex). The
+/// pieces that remain when no clique separator is left are the atoms of G.
+
+#ifndef SEPARATORS_H
+#define SEPARATORS_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "elimination_graph.h"
+
+/// \brief Subgraph of a graph on vertices [0, n): vertex i of graph is
+///        vertex vertices[i] of the original, and vertices is sorted.
+struct graph_piece
+{
+  std::vector<size_t> vertices;
+  elimination_graph graph;
+
+  graph_piece(const std::vector<size_t>& vertices_, const std::vector<std::pair<csr_vertex_t, csr_vertex_t> >& edges)
+    : vertices(vertices_), graph(vertices_.size(), edges)
+  {}
+};
+
+namespace detail
+{
+
+typedef std::pair<csr_vertex_t, csr_vertex_t> piece_edge;
+
+/* \brief The piece of g with the given edges, which are renumbered in
+ *        place; the vertices of the piece are the endpoints of the edges,
+ *        together with those in extra.
+ */
+inline
+graph_piece make_piece(std::vector<piece_edge>& edges, const std::vector<size_t>& extra = std::vector<size_t>())
+{
+  std::vector<size_t> vertices(extra);
+  for(const piece_edge& e: edges)
+  {
+    vertices.push_back(e.first);
+    vertices.push_back(e.second);
+  }
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+  const auto local = [&](csr_vertex_t v)
+  {
+    return static_cast<csr_vertex_t>(std::lower_bound(vertices.begin(), vertices.end(), v) - vertices.begin());
+  };
+  for(piece_edge& e: edges)
+    e = piece_edge(local(e.first), local(e.second));
+  return graph_piece(vertices, edges);
+}
+
+/* \brief The biconnected components of g with at least one edge, by the
+ *        algorithm of J. Hopcroft and R.E. Tarjan, "Algorithm 447: Efficient
+ *        Algorithms for Graph Manipulation", CACM 16(6), 1973.
+ *
+ * The depth-first search is iterative, and every edge is put on a stack when
+ * it is first explored; when the search returns from w to its parent v and
+ * no vertex below w reaches above v, the edges down to v -- w form a
+ * component. Every edge is in exactly one component, so this takes linear
+ * time in total.
+ */
+inline
+std::vector<graph_piece> biconnected_components(const elimination_graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing biconnected components" << std::endl;
+  const size_t unvisited = g.universe();
+  std::vector<size_t> order(g.universe(), unvisited); // discovery time
+  std::vector<size_t> low(g.universe(), 0);
+  std::vector<size_t> parent(g.universe(), unvisited);
+  std::vector<std::pair<size_t, size_t> > stack; // (vertex, index of next neighbour)
+  std::vector<piece_edge> edges;
+  std::vector<graph_piece> result;
+  size_t time = 0;
+
+  for(size_t root = 0; root < g.universe(); ++root)
+  {
+    if(g.removed(root) || order[root] != unvisited)
+      continue;
+    order[root] = low[root] = time++;
+    stack.push_back(std::make_pair(root, size_t(0)));
+    while(!stack.empty())
+    {
+      const size_t v = stack.back().first;
+      const std::vector<csr_vertex_t>& neighbours = g.neighbours(v);
+      if(stack.back().second < neighbours.size())
+      {
+        const size_t w = neighbours[stack.back().second++];
+        if(order[w] == unvisited)
+        {
+          edges.push_back(piece_edge(v, w));
+          parent[w] = v;
+          order[w] = low[w] = time++;
+          stack.push_back(std::make_pair(w, size_t(0)));
+        }
+        else if(w != parent[v] && order[w] < order[v])
+        {
+          edges.push_back(piece_edge(v, w));
+          low[v] = std::min(low[v], order[w]);
+        }
+        continue;
+      }
+
+      stack.pop_back();
+      const size_t u = parent[v];
+      if(u == unvisited)
+        continue;
+      low[u] = std::min(low[u], low[v]);
+      if(low[v] >= order[u])
+      {
+        std::vector<piece_edge> component;
+        while(true)
+        {
+          const piece_edge e = edges.back();
+          edges.pop_back();
+          component.push_back(e);
+          if(e.first == u && e.second == v)
+            break;
+        }
+        result.push_back(make_piece(component));
+      }
+    }
+  }
+  return result;
+}
+
+/* \brief The atoms of piece: the pieces obtained by repeatedly splitting
+ *        along clique separators, by the algorithm of R.E. Tarjan,
+ *        "Decomposition by Clique Separators", Discrete Mathematics 55(2),
+ *        1985.
+ *
+ * Vertices are eliminated in the given order. When x is eliminated, its
+ * neighbours S in the filled graph separate x from the later vertices; if S
+ * is a clique in piece, the component of x after removing S, together with
+ * S, is split off as an atom. For a minimal elimination ordering, such as
+ * the one from MCS-M, this finds all atoms; for other orderings every atom
+ * that is found is still safe. Every split takes linear time, so this takes
+ * O(nm) time.
+ */
+inline
+std::vector<graph_piece> clique_separator_atoms(const graph_piece& piece, const std::vector<size_t>& ordering)
+{
+  const elimination_graph& g = piece.graph;
+  const size_t n = g.universe();
+  elimination_graph filled(g);
+  std::vector<char> alive(n, 0);
+  size_t remaining = 0;
+  for(size_t v = 0; v < n; ++v)
+  {
+    alive[v] = !g.removed(v);
+    remaining += alive[v];
+  }
+
+  std::vector<graph_piece> result;
+  std::vector<char> mark(n, 0); // 1 for the separator, 2 for the component
+  std::vector<size_t> separator;
+  std::vector<size_t> component;
+  const auto split = [&](const std::vector<size_t>& atom)
+  {
+    std::vector<piece_edge> edges;
+    for(size_t v: atom)
+    {
+      for(csr_vertex_t w: g.neighbours(v))
+      {
+        if(v < w && mark[w] != 0)
+          edges.push_back(piece_edge(piece.vertices[v], piece.vertices[w]));
+      }
+    }
+    std::vector<size_t> vertices;
+    for(size_t v: atom)
+      vertices.push_back(piece.vertices[v]);
+    result.push_back(make_piece(edges, vertices));
+  };
+
+  for(size_t x: ordering)
+  {
+    separator.clear();
+    for(csr_vertex_t w: filled.neighbours(x))
+    {
+      if(alive[w])
+        separator.push_back(w);
+    }
+    filled.eliminate(x, [](size_t) {});
+    if(!alive[x] || separator.size() + 1 >= remaining)
+      continue;
+
+    bool clique = true;
+    for(size_t i = 0; clique && i < separator.size(); ++i)
+    {
+      for(size_t j = i + 1; clique && j < separator.size(); ++j)
+        clique = g.has_edge(separator[i], separator[j]);
+    }
+    if(!clique)
+      continue;
+
+    for(size_t s: separator)
+      mark[s] = 1;
+    component.assign(1, x);
+    mark[x] = 2;
+    for(size_t i = 0; i < component.size(); ++i)
+    {
+      for(csr_vertex_t w: g.neighbours(component[i]))
+      {
+        if(alive[w] && mark[w] == 0)
+        {
+          mark[w] = 2;
+          component.push_back(w);
+        }
+      }
+    }
+    if(component.size() + separator.size() < remaining)
+    {
+      std::vector<size_t> atom(component);
+      atom.insert(atom.end(), separator.begin(), separator.end());
+      split(atom);
+      for(size_t v: component)
+        alive[v] = 0;
+      remaining -= component.size();
+    }
+    for(size_t v: component)
+      mark[v] = 0;
+    for(size_t s: separator)
+      mark[s] = 0;
+  }
+
+  std::vector<size_t> atom;
+  for(size_t v = 0; v < n; ++v)
+  {
+    if(alive[v])
+    {
+      atom.push_back(v);
+      mark[v] = 1;
+    }
+  }
+  split(atom);
+  return result;
+}
+
+} // namespace detail
+
+#endif // SEPARATORS_H
@@ -0,0 +1,255 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file simd.h
+/// \brief Vectorised kernels on adjacency arrays and per-vertex counters.
+///
+/// The kernel is selected at compile time. The AVX2 code path is used when
+/// compiling with -mavx2 (e.g. through -DPGINFO_NATIVE=ON), the SSE code path
+/// is used on all other x86-64 targets, and a scalar implementation is used
+/// everywhere else.
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace detail
+{
+
+/// \brief Size of the intersection of sorted arrays, by merging.
+inline
+size_t intersection_size_scalar(const uint32_t* a, const uint32_t* a_end,
+                                const uint32_t* b, const uint32_t* b_end)
+{
+  size_t result = 0;
+  while(a != a_end && b != b_end)
+  {
+    if(*a < *b)
+      ++a;
+    else if(*b < *a)
+      ++b;
+    else
+    {
+      ++result;
+      ++a;
+      ++b;
+    }
+  }
+  return result;
+}
+
+/// \brief First position in [first, last) that is not less than x,
+///        searching with exponentially increasing steps from first.
+inline
+const uint32_t* gallop(const uint32_t* first, const uint32_t* last, uint32_t x)
+{
+  size_t step = 1;
+  const uint32_t* lo = first;
+  const uint32_t* hi = first;
+  while(hi < last && *hi < x)
+  {
+    lo = hi + 1;
+    hi = (static_cast<size_t>(last - hi) > step) ? hi + step : last;
+    step *= 2;
+  }
+  // x is in [lo, hi]
+  while(lo < hi)
+  {
+    const uint32_t* mid = lo + (hi - lo)/2;
+    if(*mid < x)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/// \brief Size of the intersection of sorted arrays, where a is much
+///        shorter than b.
+inline
+size_t intersection_size_galloping(const uint32_t* a, const uint32_t* a_end,
+                                   const uint32_t* b, const uint32_t* b_end)
+{
+  size_t result = 0;
+  for(; a != a_end && b != b_end; ++a)
+  {
+    b = gallop(b, b_end, *a);
+    if(b != b_end && *b == *a)
+    {
+      ++result;
+      ++b;
+    }
+  }
+  return result;
+}
+
+/* \brief Size of the intersection of sorted arrays, comparing blocks of
+ *        elements all-against-all.
+ *
+ * Based on the block intersection of Schlegel et al. and Lemire et al.
+ * Every pair of blocks that overlap is compared exactly once, and since the
+ * arrays do not contain duplicates every common element is counted once.
+ */
+inline
+size_t intersection_size_blocks(const uint32_t* a, const uint32_t* a_end,
+                                const uint32_t* b, const uint32_t* b_end)
+{
+  size_t result = 0;
+#if defined(__AVX2__)
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  while(a_end - a >= 8 && b_end - b >= 8)
+  {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    __m256i match = _mm256_cmpeq_epi32(va, vb);
+    for(size_t r = 1; r < 8; ++r)
+    {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+    }
+    result += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+
+    const uint32_t a_max = a[7];
+    const uint32_t b_max = b[7];
+    if(a_max <= b_max)
+      a += 8;
+    if(b_max <= a_max)
+      b += 8;
+  }
+#elif defined(__SSE2__)
+  while(a_end - a >= 4 && b_end - b >= 4)
+  {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    __m128i match = _mm_cmpeq_epi32(va, vb);
+    match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+    match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+    match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+    result += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(match)));
+
+    const uint32_t a_max = a[3];
+    const uint32_t b_max = b[3];
+    if(a_max <= b_max)
+      a += 4;
+    if(b_max <= a_max)
+      b += 4;
+  }
+#endif
+  return result + intersection_size_scalar(a, a_end, b, b_end);
+}
+
+} // namespace detail
+
+/* \brief Number of elements occurring in both [a, a_end) and [b, b_end).
+ *
+ * \pre Both arrays are sorted and do not contain duplicates.
+ *
+ * If one array is much longer than the other, the elements of the short
+ * array are located in the long one by galloping, otherwise the arrays are
+ * merged block-wise using the vectorised kernel.
+ */
+inline
+size_t intersection_size(const uint32_t* a, const uint32_t* a_end,
+                         const uint32_t* b, const uint32_t* b_end)
+{
+  const size_t na = a_end - a;
+  const size_t nb = b_end - b;
+  if(na == 0 || nb == 0)
+    return 0;
+  // Skip disjoint ranges in constant time.
+  if(a_end[-1] < *b || b_end[-1] < *a)
+    return 0;
+  if(32 * na < nb)
+    return detail::intersection_size_galloping(a, a_end, b, b_end);
+  if(32 * nb < na)
+    return detail::intersection_size_galloping(b, b_end, a, a_end);
+  return detail::intersection_size_blocks(a, a_end, b, b_end);
+}
+
+/// \brief dst[i] = max(dst[i], src[i]) for all i < n.
+/// \return whether any element of dst changed.
+inline
+bool max_bytes(uint8_t* dst, const uint8_t* src, size_t n)
+{
+  size_t i = 0;
+  bool changed = false;
+#if defined(__AVX2__)
+  __m256i diff = _mm256_setzero_si256();
+  for(; i + 32 <= n; i += 32)
+  {
+    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const __m256i m = _mm256_max_epu8(d, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    diff = _mm256_or_si256(diff, _mm256_xor_si256(d, m));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), m);
+  }
+  changed = !_mm256_testz_si256(diff, diff);
+#elif defined(__SSE2__)
+  __m128i diff = _mm_setzero_si128();
+  for(; i + 16 <= n; i += 16)
+  {
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i m = _mm_max_epu8(d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    diff = _mm_or_si128(diff, _mm_xor_si128(d, m));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), m);
+  }
+  changed = _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF;
+#endif
+  for(; i < n; ++i)
+  {
+    if(src[i] > dst[i])
+    {
+      dst[i] = src[i];
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+/// \brief dst[i] |= src[i] for all i < n.
+inline
+void or_words(uint64_t* dst, const uint64_t* src, size_t n)
+{
+  size_t i = 0;
+#if defined(__AVX2__)
+  for(; i + 4 <= n; i += 4)
+  {
+    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(d, s));
+  }
+#elif defined(__SSE2__)
+  for(; i + 2 <= n; i += 2)
+  {
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(d, s));
+  }
+#endif
+  for(; i < n; ++i)
+    dst[i] |= src[i];
+}
+
+/// \brief Number of bits set in the words [words, words + n).
+inline
+size_t popcount_words(const uint64_t* words, size_t n)
+{
+  size_t result = 0;
+  for(size_t i = 0; i < n; ++i)
+    result += __builtin_popcountll(words[i]);
+  return result;
+}
+
+#endif // SIMD_H
@@ -0,0 +1,182 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file sweep.h
+/// \brief A single BFS from every vertex that serves the diameter, the girth
+///        and the neighbourhood sizes at the same time.
+///
+/// From source s, the eccentricity of s is the last non-empty BFS level, the
+/// shortest cycle through s is closed by the first edge back into s, and the
+/// k-neighbourhood of s consists of the first k levels.
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "csr.h"
+#include "neighbourhood.h"
+#include "parallel.h"
+
+struct sweep_options
+{
+  bool diameter;
+  bool girth;
+  bool neighbourhoods;
+  size_t neighbourhoods_upto;
+
+  sweep_options()
+    : diameter(false), girth(false), neighbourhoods(false), neighbourhoods_upto(0)
+  {}
+};
+
+struct sweep_result
+{
+  size_t diameter; ///< Maximal eccentricity of a vertex.
+  size_t girth;    ///< Length of the shortest cycle; max if there is none.
+  std::vector<neighbourhood_result> neighbourhoods; ///< As accumulated_upto_kneighbourhood.
+
+  sweep_result()
+    : diameter(0), girth(std::numeric_limits<size_t>::max())
+  {}
+};
+
+namespace detail
+{
+
+/// \brief The neighbourhood engine, extended with the eccentricity and the
+///        shortest cycle through the source.
+class sweep_engine: public neighbourhood_engine
+{
+public:
+  sweep_engine(const csr_graph& g)
+    : neighbourhood_engine(g)
+  {}
+
+  /* \brief BFS from v that expands at most max_level levels.
+   *
+   * Cycles through v are only looked for if they are shorter than
+   * cycle_bound; the BFS stops once max_level levels have been expanded,
+   * unless a full traversal was requested for the eccentricity. levels[i]
+   * is set to the number of vertices at distance 1, ..., i from v, for
+   * i < levels.size().
+   */
+  void sweep(size_t v, bool full, size_t cycle_bound, std::vector<size_t>& levels,
+             size_t& eccentricity, size_t& cycle)
+  {
+    std::fill(levels.begin(), levels.end(), 0);
+    eccentricity = 0;
+    cycle = std::numeric_limits<size_t>::max();
+    next_epoch();
+    m_queue.clear();
+    m_queue.push_back(static_cast<csr_vertex_t>(v));
+    m_visited[v] = m_epoch;
+
+    const size_t k = levels.empty() ? 0 : levels.size() - 1;
+    size_t level_begin = 0;
+    for(size_t level = 1; level_begin < m_queue.size(); ++level)
+    {
+      const bool need_cycle = cycle == std::numeric_limits<size_t>::max() && level < cycle_bound;
+      if(!full && !need_cycle && level > k)
+        break;
+
+      const size_t level_end = m_queue.size();
+      for(size_t i = level_begin; i < level_end; ++i)
+      {
+        const size_t u = m_queue[i];
+        for(const csr_vertex_t* w = m_g.begin(u); w != m_g.end(u); ++w)
+        {
+          if(*w == v && need_cycle)
+            cycle = level;
+          if(m_visited[*w] != m_epoch)
+          {
+            m_visited[*w] = m_epoch;
+            m_queue.push_back(*w);
+          }
+        }
+      }
+      level_begin = level_end;
+      if(level_end < m_queue.size())
+        eccentricity = level;
+      if(level <= k)
+        levels[level] = m_queue.size() - 1;
+    }
+    for(size_t level = 1; level <= k; ++level)
+      levels[level] = std::max(levels[level], levels[level-1]);
+  }
+};
+
+/// \brief Thread-local part of the sweep result, padded to avoid false
+///        sharing.
+struct padded_sweep_result
+{
+  size_t diameter;
+  std::vector<size_t> levels;
+  char padding[64];
+
+  padded_sweep_result()
+    : diameter(0)
+  {}
+};
+
+} // namespace detail
+
+/* \brief Compute the measures selected in options using one BFS from every
+ *        vertex.
+ *
+ * The sources are distributed over the threads, each of which reuses a
+ * single sweep_engine. The shortest cycle found so far is shared between
+ * the threads, and bounds the depth of the remaining searches whenever the
+ * diameter is not needed.
+ */
+template<typename Graph>
+inline
+sweep_result all_sources_sweep(const Graph& g, const sweep_options& options)
+{
+  cpplog(cpplogging::verbose) << "Computing BFS from all vertices" << std::endl;
+  const csr_graph c = make_csr(g);
+  const size_t k = options.neighbourhoods ? options.neighbourhoods_upto : 0;
+
+  std::vector<std::unique_ptr<detail::sweep_engine> > engines(num_threads());
+  std::vector<detail::padded_sweep_result> results(num_threads());
+  std::vector<std::vector<neighbourhood_result> > neighbourhoods(num_threads(), std::vector<neighbourhood_result>(k+1));
+  std::atomic<size_t> girth(std::numeric_limits<size_t>::max());
+
+  parallel_for(0, c.num_vertices(), [&](size_t v, size_t thread)
+  {
+    if(!engines[thread])
+    {
+      engines[thread].reset(new detail::sweep_engine(c));
+      results[thread].levels.resize(options.neighbourhoods ? k+1 : 0);
+    }
+    detail::padded_sweep_result& local = results[thread];
+    size_t eccentricity;
+    size_t cycle;
+    engines[thread]->sweep(v, options.diameter, options.girth ? girth.load() : 0,
+                           local.levels, eccentricity, cycle);
+    local.diameter = std::max(local.diameter, eccentricity);
+    if(options.girth)
+      detail::atomic_min(girth, cycle);
+    if(options.neighbourhoods)
+      detail::accumulate_neighbourhood(local.levels.data(), k, neighbourhoods[thread]);
+  }, 16);
+
+  sweep_result result;
+  result.girth = girth.load();
+  for(const detail::padded_sweep_result& local: results)
+    result.diameter = std::max(result.diameter, local.diameter);
+  if(options.neighbourhoods)
+    result.neighbourhoods = detail::merge_neighbourhood_results(neighbourhoods, k);
+  return result;
+}
+
+#endif // SWEEP_H
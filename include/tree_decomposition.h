@@ -0,0 +1,265 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file tree_decomposition.h
+/// \brief Tree decompositions induced by elimination orderings, a validator,
+///        and output in the .td format of the PACE challenge.
+///
+/// Eliminating v puts v and its remaining neighbours in a bag; the parent of
+/// that bag is the bag of the neighbour that is eliminated first. The
+/// remaining neighbours of v are its later neighbours in the original graph,
+/// together with the bags of the children of v, so all bags are computed in
+/// time linear in the size of the graph and the decomposition, without
+/// computing the fill-in explicitly.
+
+#ifndef TREE_DECOMPOSITION_H
+#define TREE_DECOMPOSITION_H
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "elimination_graph.h"
+
+struct tree_decomposition_t
+{
+  /// \brief The bags; bags[i] starts with the vertex eliminated i-th.
+  std::vector<std::vector<size_t> > bags;
+  /// \brief The edges of the tree, between indices of bags.
+  std::vector<std::pair<size_t, size_t> > edges;
+
+  /// \brief Size of the largest bag minus one.
+  size_t width() const
+  {
+    size_t result = 0;
+    for(const std::vector<size_t>& bag: bags)
+      result = std::max(result, bag.size());
+    return result == 0 ? 0 : result - 1;
+  }
+};
+
+namespace detail
+{
+
+/* \brief The tree decomposition of g induced by ordering.
+ * \pre ordering contains every vertex of g that has not been removed once.
+ *
+ * Bags of different components are joined into a path, since a tree
+ * decomposition needs to be a tree.
+ */
+inline
+tree_decomposition_t tree_decomposition(const elimination_graph& g, const std::vector<size_t>& ordering)
+{
+  const size_t none = std::numeric_limits<size_t>::max();
+  const size_t n = ordering.size();
+  std::vector<size_t> position(g.universe(), none);
+  for(size_t i = 0; i < n; ++i)
+    position[ordering[i]] = i;
+
+  tree_decomposition_t result;
+  result.bags.resize(n);
+  std::vector<size_t> first_child(n, none); // children as linked lists
+  std::vector<size_t> next_sibling(n, none);
+  std::vector<size_t> mark(g.universe(), none);
+  size_t previous_root = none;
+  for(size_t i = 0; i < n; ++i)
+  {
+    const size_t v = ordering[i];
+    std::vector<size_t>& bag = result.bags[i];
+    bag.push_back(v);
+    mark[v] = i;
+    const auto add = [&](size_t w)
+    {
+      if(position[w] > i && mark[w] != i)
+      {
+        mark[w] = i;
+        bag.push_back(w);
+      }
+    };
+    for(csr_vertex_t w: g.neighbours(v))
+      add(w);
+    for(size_t c = first_child[i]; c != none; c = next_sibling[c])
+    {
+      for(size_t w: result.bags[c])
+        add(w);
+    }
+
+    size_t parent = none;
+    for(size_t j = 1; j < bag.size(); ++j)
+      parent = std::min(parent, position[bag[j]]);
+    if(parent != none)
+    {
+      next_sibling[i] = first_child[parent];
+      first_child[parent] = i;
+      result.edges.push_back(std::make_pair(i, parent));
+    }
+    else
+    {
+      if(previous_root != none)
+        result.edges.push_back(std::make_pair(previous_root, i));
+      previous_root = i;
+    }
+  }
+  return result;
+}
+
+/* \brief Whether td is a tree decomposition of g.
+ *
+ * Checks that the edges form a tree, and roots it. Every vertex must then
+ * occur in exactly one bag whose parent does not contain it, its top bag,
+ * which means its bags form a subtree. The subtrees of two vertices
+ * intersect if and only if the deeper of the two top bags contains the other
+ * vertex, so the edges are checked in linear time as well.
+ */
+inline
+bool is_tree_decomposition(const elimination_graph& g, const tree_decomposition_t& td)
+{
+  const size_t none = std::numeric_limits<size_t>::max();
+  const size_t bags = td.bags.size();
+  if(bags == 0)
+    return g.num_vertices() == 0;
+  if(td.edges.size() != bags - 1)
+    return false;
+
+  std::vector<std::vector<size_t> > tree(bags);
+  for(const std::pair<size_t, size_t>& e: td.edges)
+  {
+    if(e.first >= bags || e.second >= bags || e.first == e.second)
+      return false;
+    tree[e.first].push_back(e.second);
+    tree[e.second].push_back(e.first);
+  }
+  std::vector<size_t> parent(bags, none);
+  std::vector<size_t> depth(bags, none);
+  std::vector<size_t> queue(1, 0);
+  depth[0] = 0;
+  for(size_t i = 0; i < queue.size(); ++i)
+  {
+    for(size_t c: tree[queue[i]])
+    {
+      if(depth[c] == none)
+      {
+        depth[c] = depth[queue[i]] + 1;
+        parent[c] = queue[i];
+        queue.push_back(c);
+      }
+    }
+  }
+  if(queue.size() != bags)
+    return false;
+
+  std::vector<size_t> top(g.universe(), none);
+  std::vector<size_t> mark(g.universe(), none);
+  for(size_t b: queue)
+  {
+    for(size_t v: td.bags[b])
+    {
+      if(v >= g.universe() || g.removed(v) || mark[v] == b)
+        return false;
+      mark[v] = b;
+    }
+    for(size_t c: tree[b])
+    {
+      if(c == parent[b])
+        continue;
+      for(size_t v: td.bags[c])
+      {
+        if(v < g.universe() && mark[v] != b)
+        {
+          if(top[v] != none)
+            return false;
+          top[v] = c;
+        }
+      }
+    }
+    if(b == 0)
+    {
+      for(size_t v: td.bags[b])
+        top[v] = b;
+    }
+  }
+
+  std::vector<std::vector<size_t> > tops(bags);
+  for(size_t v = 0; v < g.universe(); ++v)
+  {
+    if(g.removed(v))
+      continue;
+    if(top[v] == none)
+      return false;
+    tops[top[v]].push_back(v);
+  }
+  for(size_t b = 0; b < bags; ++b)
+  {
+    for(size_t v: td.bags[b])
+      mark[v] = b;
+    for(size_t v: tops[b])
+    {
+      for(csr_vertex_t w: g.neighbours(v))
+      {
+        if(depth[top[w]] <= depth[b] && mark[w] != b)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+/// \brief The tree decomposition of the undirected graph underlying g that
+///        is induced by the elimination ordering, e.g. of an upper bound on
+///        treewidth.
+template <typename Graph>
+tree_decomposition_t tree_decomposition(const Graph& g, const std::vector<size_t>& ordering)
+{
+  cpplog(cpplogging::verbose) << "Computing tree decomposition" << std::endl;
+  return detail::tree_decomposition(elimination_graph(g), ordering);
+}
+
+/// \brief Whether td is a tree decomposition of the undirected graph
+///        underlying g.
+template <typename Graph>
+bool is_tree_decomposition(const Graph& g, const tree_decomposition_t& td)
+{
+  cpplog(cpplogging::verbose) << "Validating tree decomposition" << std::endl;
+  return detail::is_tree_decomposition(elimination_graph(g), td);
+}
+
+/* \brief Print td in the .td format of the PACE challenge, with vertices
+ *        and bags numbered from 1, for a graph with num_vertices vertices.
+ *
+ * If ordering is not empty, it is included as a comment line
+ * "c ordering v1 v2 ...".
+ */
+inline
+void print_pace_td(const tree_decomposition_t& td, size_t num_vertices, std::ostream& os,
+                   const std::vector<size_t>& ordering = std::vector<size_t>())
+{
+  cpplog(cpplogging::verbose) << "Printing tree decomposition." << std::endl;
+  if(!ordering.empty())
+  {
+    os << "c ordering";
+    for(size_t v: ordering)
+      os << " " << v + 1;
+    os << "\n";
+  }
+  os << "s td " << td.bags.size() << " " << (td.bags.empty() ? 0 : td.width() + 1) << " " << num_vertices << "\n";
+  for(size_t b = 0; b < td.bags.size(); ++b)
+  {
+    os << "b " << b + 1;
+    for(size_t v: td.bags[b])
+      os << " " << v + 1;
+    os << "\n";
+  }
+  for(const std::pair<size_t, size_t>& e: td.edges)
+    os << e.first + 1 << " " << e.second + 1 << "\n";
+}
+
+#endif // TREE_DECOMPOSITION_H
@@ -12,13 +12,28 @@
 #ifndef TREEWIDTH_H
 #define TREEWIDTH_H
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
 #include <limits>
-#include <boost/graph/copy.hpp>
-#include <boost/heap/fibonacci_heap.hpp>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
 #include "cpplogging/logger.h"
 #include "cpplogging/progress_meter.h"
 
-#include "graph_utilities.h"
+#include "anytime.h"
+#include "bucket_queue.h"
+#include "budget.h"
+#include "elimination_graph.h"
+#include "parallel.h"
+#include "separators.h"
+#include "simd.h"
 
 /* According to Obdrzalek in ... 2006, p.40
  * "There is an easy way to generalise the concept of tree-width to directed
@@ -28,6 +43,196 @@
  *  freely talk about tree-width and tree decompositions of directed graphs."
  */
 
+/* Safe reduction rules of H.L. Bodlaender, A.M.C.A. Koster and F. van den
+ * Eijkhof, "Preprocessing Rules for Triangulation of Probabilistic
+ * Networks", Computational Intelligence 21(3), 2005. Every rule eliminates a
+ * vertex v, and maintains a lower bound low such that the treewidth of the
+ * original graph is the maximum of low and the treewidth of the reduced
+ * graph:
+ * - Islet: v has degree 0.
+ * - Twig: v has degree 1; low becomes at least 1.
+ * - Series: v has degree 2, and low >= 2.
+ * - Triangle: v has degree 3, two of its neighbours are adjacent, and
+ *   low >= 3.
+ * - Simplicial: the neighbours of v form a clique; low becomes at least the
+ *   degree of v.
+ * - Almost simplicial: all neighbours of v but one form a clique, and the
+ *   degree of v is at most low.
+ * The graph that remains when no rule applies is the kernel. Its minimum
+ * degree is a lower bound on its treewidth; raising low to it may enable
+ * more rules, so the rules are applied again until low no longer changes.
+ *
+ * The eliminated vertices, in order, form an elimination ordering of width
+ * at most low, which can be completed by any ordering of the kernel.
+ */
+
+namespace detail
+{
+
+/* \brief Whether v is simplicial in g (its neighbours form a clique), or
+ *        almost simplicial (all but one of its neighbours, set in other,
+ *        form a clique).
+ *
+ * Gives up as soon as two neighbours each miss more than one other
+ * neighbour, so that vertices of high degree are rejected quickly.
+ */
+inline
+bool simplicial(const elimination_graph& g, size_t v, bool& almost, size_t& other)
+{
+  const std::vector<csr_vertex_t>& neighbours = g.neighbours(v);
+  const size_t d = neighbours.size();
+  almost = false;
+  size_t sparse = 0; // neighbours that are adjacent to fewer than d - 2 others
+  for(csr_vertex_t u: neighbours)
+  {
+    if(g.degree(u) + 1 < d && ++sparse > 1)
+      return false;
+  }
+
+  size_t missing = 0; // twice the number of non-adjacent pairs of neighbours
+  size_t most = 0;    // number of non-neighbours of other among the neighbours
+  size_t spread = 0;  // neighbours that miss more than one other neighbour
+  for(csr_vertex_t u: neighbours)
+  {
+    const std::vector<csr_vertex_t>& adjacent = g.neighbours(u);
+    const size_t common = intersection_size(neighbours.data(), neighbours.data() + d, adjacent.data(), adjacent.data() + adjacent.size());
+    const size_t miss = d - 1 - common;
+    if(miss > 1 && ++spread > 1)
+      return false;
+    missing += miss;
+    if(miss > most)
+    {
+      most = miss;
+      other = u;
+    }
+  }
+  if(missing == 0)
+    return true;
+  almost = (most == missing/2);
+  return false;
+}
+
+/* \brief Apply the safe reduction rules to g until none applies, leaving
+ *        the kernel in g.
+ *
+ * If eliminated is given, the eliminated vertices are appended to it in
+ * order.
+ * \return low, so that the treewidth of g was the maximum of low and the
+ *         treewidth of the kernel.
+ */
+inline
+size_t reduce_destructive(elimination_graph& g, std::vector<size_t>* eliminated = 0)
+{
+  cpplog(cpplogging::verbose) << "Applying treewidth reduction rules" << std::endl;
+  size_t low = 0;
+  std::vector<size_t> work;
+  std::vector<char> queued(g.universe(), 0);
+  const auto enqueue = [&](size_t v)
+  {
+    if(!queued[v])
+    {
+      queued[v] = 1;
+      work.push_back(v);
+    }
+  };
+  const auto eliminate = [&](size_t v)
+  {
+    if(eliminated)
+      eliminated->push_back(v);
+    g.eliminate(v, enqueue);
+  };
+
+  while(true)
+  {
+    for(size_t v = 0; v < g.universe(); ++v)
+    {
+      if(!g.removed(v))
+        enqueue(v);
+    }
+    while(!work.empty())
+    {
+      const size_t v = work.back();
+      work.pop_back();
+      queued[v] = 0;
+      const size_t d = g.degree(v);
+      const std::vector<csr_vertex_t>& neighbours = g.neighbours(v);
+      bool almost;
+      size_t other;
+      if(d <= 1)
+      {
+        low = std::max(low, d);
+        eliminate(v);
+      }
+      else if(d == 2 && low >= 2)
+        eliminate(v);
+      else if(d == 3 && low >= 3 && (g.has_edge(neighbours[0], neighbours[1]) ||
+                                     g.has_edge(neighbours[0], neighbours[2]) ||
+                                     g.has_edge(neighbours[1], neighbours[2])))
+        eliminate(v);
+      else if(simplicial(g, v, almost, other))
+      {
+        low = std::max(low, d);
+        eliminate(v);
+      }
+      else if(almost && d <= low)
+        eliminate(v);
+    }
+
+    size_t degree = std::numeric_limits<size_t>::max();
+    for(size_t v = 0; v < g.universe(); ++v)
+    {
+      if(!g.removed(v))
+        degree = std::min(degree, g.degree(v));
+    }
+    if(g.num_vertices() == 0 || degree <= low)
+      return low;
+    low = degree;
+  }
+}
+
+} // namespace detail
+
+/// \brief Size of the kernel of (the undirected graph underlying) g under
+///        the safe reduction rules, and the lower bound they certify.
+struct treewidth_kernel_t
+{
+  size_t lower_bound;
+  size_t vertices;
+  size_t edges;
+};
+
+/* \brief The undirected graph underlying a graph, reduced once by the safe
+ *        reduction rules, so that several bounds can share the reduction.
+ *
+ * The rules take quadratic time on graphs with hubs; the bounds that take a
+ * treewidth_reduction do not reduce the graph again.
+ */
+struct treewidth_reduction
+{
+  elimination_graph graph;     ///< the undirected graph underlying the input
+  elimination_graph kernel;    ///< graph with the reduced vertices eliminated
+  std::vector<size_t> reduced; ///< the reduced vertices, in elimination order
+  size_t lower_bound;          ///< the lower bound certified by the rules
+
+  template <typename Graph>
+  explicit treewidth_reduction(const Graph& g)
+    : graph(g), kernel(graph), lower_bound(detail::reduce_destructive(kernel, &reduced))
+  {}
+
+  treewidth_kernel_t statistics() const
+  {
+    treewidth_kernel_t result = { lower_bound, kernel.num_vertices(), kernel.num_edges() };
+    return result;
+  }
+};
+
+template <typename Graph>
+inline
+treewidth_kernel_t treewidth_kernel(const Graph& g)
+{
+  return treewidth_reduction(g).statistics();
+}
+
 /* Known algorithms for computing upperbound on treewidth:
  * - LexBFS
  * - MaximumCardinalitySearch
@@ -35,183 +240,748 @@
  * as well as variations of the above started from each vertex.
  *
  * All of these algorithms return permutations that must be transformed
- * into a tree decomposition to get an upperbound on treewidth.
+ * into a tree decomposition to get an upperbound on treewidth; the width of
+ * the elimination ordering that is the reverse of the permutation is such
+ * a bound.
  *
  * - GreedyDegree --
  * - GreedyFillIn -- (TACO 2006 always at least as good as the others)
+ *
+ * All of them are implemented below, except for the variations started from
+ * each vertex.
  */
 
 namespace detail
 {
-/* \brief Eliminate a vertex v.
+
+/* \brief Upper bound on treewidth by repeatedly eliminating a vertex of
+ *        minimum degree from g.
+ *
+ * Vertices are kept in a bucket queue by degree; among the vertices of
+ * minimum degree the one whose degree changed last is eliminated first.
+ * If ordering is given, the elimination ordering is appended to it. If
+ * random is given, the vertices enter the queue in random order, which
+ * breaks the initial ties randomly.
+ */
+inline
+size_t greedy_degree_destructive(elimination_graph& g, std::vector<size_t>* ordering = 0, std::mt19937* random = 0)
+{
+  cpplog(cpplogging::verbose) << "Computing greedy degree" << std::endl;
+  cpplogging::progress_meter progress(g.num_vertices());
+
+  bucket_queue queue(g.universe(), g.universe());
+  for(size_t v: tie_breaking_order(g.universe(), random))
+  {
+    if(!g.removed(v))
+      queue.push(v, g.degree(v));
+  }
+
+  size_t upperbound = 0;
+  while(!queue.empty())
+  {
+    progress.step();
+    const size_t u = queue.pop();
+    upperbound = std::max(upperbound, g.degree(u));
+    if(ordering)
+      ordering->push_back(u);
+    g.eliminate(u, [&](size_t w) { queue.update(w, g.degree(w)); });
+  }
+  return upperbound;
+}
+
+/// \brief Number of pairs of neighbours of v in g that are not adjacent.
+inline
+size_t fill_in(const elimination_graph& g, size_t v)
+{
+  const std::vector<csr_vertex_t>& neighbours = g.neighbours(v);
+  size_t inner_edges = 0; // counted twice
+  for(csr_vertex_t u: neighbours)
+  {
+    const std::vector<csr_vertex_t>& adjacent = g.neighbours(u);
+    if(!adjacent.empty() && !neighbours.empty())
+      inner_edges += intersection_size(neighbours.data(), neighbours.data() + neighbours.size(),
+                                       adjacent.data(), adjacent.data() + adjacent.size());
+  }
+  const size_t d = neighbours.size();
+  return d*(d - 1)/2 - inner_edges/2;
+}
+
+/* \brief Upper bound on treewidth by repeatedly eliminating a vertex that
+ *        adds the fewest edges, breaking ties by minimum degree.
  *
- * v is eliminated by adding edges u -- w for all u,w s.t. u,w -- v, u != w.
- * Priority pq is updated accordingly.
+ * The fill-in of every vertex is maintained incrementally: eliminating v
+ * only changes the neighbourhoods of the neighbours of v, whose fill-in is
+ * recomputed; any other vertex w loses one missing edge for every added
+ * edge between two neighbours of w.
  *
- * \pre v \not \in pq.
- * \pre v -- v \not \in edges(g).
+ * The remaining ties are broken by vertex number, or randomly if random is
+ * given.
  */
-template <typename UndirectedGraph, class PriorityQueue, class HandleMap>
 inline
-void eliminate_vertex(typename boost::graph_traits<UndirectedGraph>::vertex_descriptor v,
-                   UndirectedGraph& g,
-                   PriorityQueue& pq,
-                   HandleMap& handle)
+size_t greedy_fill_in_destructive(elimination_graph& g, std::vector<size_t>* ordering = 0, std::mt19937* random = 0)
 {
-  typedef typename boost::graph_traits<UndirectedGraph>::vertex_descriptor vertex_t;
-  typename boost::graph_traits<UndirectedGraph>::adjacency_iterator ai, aj, aend;
-  typedef typename PriorityQueue::handle_type handle_t;
+  cpplog(cpplogging::verbose) << "Computing greedy fill-in" << std::endl;
+  cpplogging::progress_meter progress(g.num_vertices());
 
-  boost::tie(ai, aend) = boost::adjacent_vertices(v, g);
-  while(ai != aend)
+  typedef std::pair<std::pair<size_t, size_t>, size_t> entry_t; // ((fill-in, degree), rank)
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t> > queue;
+  const std::vector<size_t> vertex = tie_breaking_order(g.universe(), random); // of every rank
+  std::vector<size_t> rank(g.universe());
+  for(size_t i = 0; i < vertex.size(); ++i)
+    rank[vertex[i]] = i;
+  const auto push = [&](size_t v, size_t fill_v)
+  {
+    queue.push(std::make_pair(std::make_pair(fill_v, g.degree(v)), rank[v]));
+  };
+  std::vector<size_t> fill(g.universe(), 0);
+  for(size_t v = 0; v < g.universe(); ++v)
   {
-    vertex_t u = *ai;
-    aj = ai;
-    ++aj;
-    while(aj != aend)
+    if(g.removed(v))
+      continue;
+    fill[v] = fill_in(g, v);
+    push(v, fill[v]);
+  }
+
+  std::vector<char> in_neighbourhood(g.universe(), 0);
+  std::vector<std::pair<csr_vertex_t, csr_vertex_t> > added;
+  size_t upperbound = 0;
+  while(!queue.empty())
+  {
+    const entry_t top = queue.top();
+    queue.pop();
+    const size_t v = vertex[top.second];
+    if(g.removed(v) || top.first.first != fill[v] || top.first.second != g.degree(v))
+      continue; // outdated entry
+    progress.step();
+    upperbound = std::max(upperbound, g.degree(v));
+    if(ordering)
+      ordering->push_back(v);
+
+    const std::vector<csr_vertex_t> neighbours = g.neighbours(v);
+    for(csr_vertex_t u: neighbours)
+      in_neighbourhood[u] = 1;
+    added.clear();
+    g.eliminate(v, [](size_t) {}, [&](size_t a, size_t b)
+    {
+      added.push_back(std::make_pair(static_cast<csr_vertex_t>(a), static_cast<csr_vertex_t>(b)));
+    });
+
+    // Common neighbours of the endpoints of an added edge, outside the
+    // neighbourhood of v.
+    for(const std::pair<csr_vertex_t, csr_vertex_t>& e: added)
     {
-      vertex_t w = *aj;
-      if(u != v && u != w && v != w)
+      const std::vector<csr_vertex_t>& a = g.neighbours(e.first);
+      const std::vector<csr_vertex_t>& b = g.neighbours(e.second);
+      std::vector<csr_vertex_t>::const_iterator i = a.begin(), j = b.begin();
+      while(i != a.end() && j != b.end())
       {
-        if(boost::add_edge(u, w, g).second)
+        if(*i < *j)
+          ++i;
+        else if(*j < *i)
+          ++j;
+        else
         {
-          pq.decrease(handle[u]);
-          pq.decrease(handle[w]);
+          if(!in_neighbourhood[*i])
+          {
+            --fill[*i];
+            push(*i, fill[*i]);
+          }
+          ++i;
+          ++j;
         }
       }
-      ++aj;
     }
-    ai++;
-    boost::remove_edge(v, u, g);
-    // no pq.increase(handle[v]) since v is not in pq.
-    pq.increase(handle[u]);
+
+    for(csr_vertex_t u: neighbours)
+    {
+      in_neighbourhood[u] = 0;
+      fill[u] = fill_in(g, u);
+      push(u, fill[u]);
+    }
   }
+  return upperbound;
 }
 
-template <typename UndirectedGraph>
+/* \brief Width of the elimination ordering, i.e. the maximal degree of a
+ *        vertex when it is eliminated; g is destroyed.
+ */
 inline
-typename boost::graph_traits<UndirectedGraph>::vertices_size_type
-greedy_degree_destructive(UndirectedGraph& g)
+size_t elimination_width_destructive(elimination_graph& g, const std::vector<size_t>& ordering)
 {
-  typedef typename boost::graph_traits<UndirectedGraph>::vertices_size_type vertex_size_t;
-  typedef typename boost::graph_traits<UndirectedGraph>::vertex_descriptor vertex_t;
+  size_t result = 0;
+  for(size_t v: ordering)
+  {
+    result = std::max(result, g.degree(v));
+    g.eliminate(v, [](size_t) {});
+  }
+  return result;
+}
 
-  cpplog(cpplogging::verbose) << "Computing greedy degree" << std::endl;
-  cpplogging::progress_meter progress(boost::num_vertices(g));
+/* \brief Elimination ordering from a maximum cardinality search on g: the
+ *        reverse of the order in which vertices are visited, where every
+ *        step visits a vertex with the most visited neighbours.
+ *
+ * If random is given, the search starts in a random vertex, and the initial
+ * ties are broken randomly.
+ */
+inline
+std::vector<size_t> maximum_cardinality_search(const elimination_graph& g, std::mt19937* random)
+{
+  cpplog(cpplogging::verbose) << "Computing MCS ordering" << std::endl;
+  bucket_queue queue(g.universe(), g.universe());
+  for(size_t v: tie_breaking_order(g.universe(), random))
+  {
+    if(!g.removed(v))
+      queue.push(v, 0);
+  }
+  std::vector<size_t> result(queue.size());
+  for(size_t i = result.size(); i-- > 0; )
+  {
+    const size_t v = queue.pop_max();
+    result[i] = v;
+    for(csr_vertex_t u: g.neighbours(v))
+    {
+      if(queue.contains(u))
+        queue.update(u, queue.key(u) + 1);
+    }
+  }
+  return result;
+}
 
-  // We do not count selfloops, first remove so we can use out_degree to
-  // determine the neighbourhood.
-  remove_selfloops(g);
+/// \brief Elimination ordering from a maximum cardinality search on g.
+inline
+std::vector<size_t> mcs_ordering(const elimination_graph& g)
+{
+  return maximum_cardinality_search(g, 0);
+}
+
+/* \brief Elimination ordering from a lexicographic breadth-first search on
+ *        g: the reverse of the order in which vertices are visited.
+ *
+ * Implemented by partition refinement: the unvisited vertices are kept in
+ * an array of cells, ordered by decreasing label. Visiting v moves its
+ * unvisited neighbours to the front of their cells, and then splits off
+ * those fronts into new cells just before the old ones.
+ */
+inline
+std::vector<size_t> lex_bfs_ordering(const elimination_graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing LexBFS ordering" << std::endl;
+  std::vector<size_t> order;
+  for(size_t v = 0; v < g.universe(); ++v)
+  {
+    if(!g.removed(v))
+      order.push_back(v);
+  }
+  const size_t n = order.size();
+  std::vector<size_t> position(g.universe(), 0);
+  for(size_t i = 0; i < n; ++i)
+    position[order[i]] = i;
 
-  // Build priority queue, sorted by outdegree, and record the handles.
-  typedef outdegree_greater<UndirectedGraph> cmp_t;
-  typedef boost::heap::fibonacci_heap<vertex_t, boost::heap::compare<cmp_t> > priority_queue_t;
-  typedef typename priority_queue_t::handle_type handle_t;
-  cmp_t cmp(g);
-  priority_queue_t pq(cmp);
-  std::vector<handle_t> handles;
+  // Cells are ranges [begin, end) of order; moved counts the vertices moved
+  // to the front of a cell during the current step.
+  std::vector<size_t> cell(g.universe(), 0);
+  std::vector<size_t> begin(1, 0), end(1, n), moved(1, 0);
+  std::vector<size_t> touched;
 
-  typename boost::graph_traits<UndirectedGraph>::vertex_iterator i, end;
-  for(boost::tie(i,end) = boost::vertices(g); i != end; ++i)
+  for(size_t i = 0; i < n; ++i)
   {
-    handles.push_back(pq.push(*i));
+    const size_t v = order[i];
+    ++begin[cell[v]];
+    touched.clear();
+    for(csr_vertex_t u: g.neighbours(v))
+    {
+      if(position[u] <= i)
+        continue;
+      const size_t c = cell[u];
+      if(moved[c] == 0)
+        touched.push_back(c);
+      const size_t front = begin[c] + moved[c]++;
+      const size_t w = order[front];
+      std::swap(order[position[u]], order[front]);
+      position[w] = position[u];
+      position[u] = front;
+    }
+    for(size_t c: touched)
+    {
+      if(moved[c] < end[c] - begin[c])
+      {
+        const size_t split = begin.size();
+        begin.push_back(begin[c]);
+        end.push_back(begin[c] + moved[c]);
+        moved.push_back(0);
+        for(size_t j = begin[split]; j < end[split]; ++j)
+          cell[order[j]] = split;
+        begin[c] = end[split];
+      }
+      moved[c] = 0;
+    }
   }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
 
-  // Compute the upperbound according to the greedy degree algorithm.
-  vertex_size_t upperbound = std::numeric_limits<vertex_size_t>::min();
+/* \brief Elimination ordering from MCS-M (A. Berry, J.R.S. Blair, P.
+ *        Heggernes and B.W. Peyton, "Maximum Cardinality Search for
+ *        Computing Minimal Triangulations of Graphs", Algorithmica 39(4),
+ *        2004), which yields a minimal triangulation.
+ *
+ * Like MCS, but visiting v increases the weight of every unvisited u that
+ * can be reached from v through unvisited vertices of weight less than that
+ * of u. Every step is a search over the unvisited vertices, so this takes
+ * O(nm) time.
+ */
+inline
+std::vector<size_t> mcs_m_ordering(const elimination_graph& g)
+{
+  cpplog(cpplogging::verbose) << "Computing MCS-M ordering" << std::endl;
+  const size_t universe = g.universe();
+  bucket_queue queue(universe, universe);
+  for(size_t v = 0; v < universe; ++v)
+  {
+    if(!g.removed(v))
+      queue.push(v, 0);
+  }
 
-  while(!pq.empty())
+  std::vector<size_t> result(queue.size());
+  std::vector<size_t> reached_in(universe, 0); // step + 1 in which a vertex was reached
+  std::vector<std::vector<size_t> > reach(universe + 1);
+  std::vector<size_t> increase;
+  for(size_t i = result.size(); i-- > 0; )
   {
-    progress.step();
-    vertex_t u = pq.top();
-    pq.pop();
-    upperbound = std::max(upperbound, boost::out_degree(u, g));
-    eliminate_vertex(u, g, pq, handles);
+    const size_t v = queue.pop_max();
+    result[i] = v;
+    const size_t step = i + 1;
+    reached_in[v] = step;
+    increase.clear();
+    size_t lowest = universe;
+    size_t highest = 0;
+    for(csr_vertex_t u: g.neighbours(v))
+    {
+      if(!queue.contains(u))
+        continue;
+      reached_in[u] = step;
+      increase.push_back(u);
+      reach[queue.key(u)].push_back(u);
+      lowest = std::min(lowest, queue.key(u));
+      highest = std::max(highest, queue.key(u));
+    }
+    for(size_t j = lowest; j <= highest; ++j)
+    {
+      while(!reach[j].empty())
+      {
+        const size_t y = reach[j].back();
+        reach[j].pop_back();
+        for(csr_vertex_t z: g.neighbours(y))
+        {
+          if(!queue.contains(z) || reached_in[z] == step)
+            continue;
+          reached_in[z] = step;
+          if(queue.key(z) > j)
+          {
+            increase.push_back(z);
+            reach[queue.key(z)].push_back(z);
+            highest = std::max(highest, queue.key(z));
+          }
+          else
+            reach[j].push_back(z);
+        }
+      }
+    }
+    for(size_t u: increase)
+      queue.update(u, queue.key(u) + 1);
   }
-  return upperbound;
+  return result;
 }
+
+/// \brief Elimination ordering of greedy degree on g.
+inline
+std::vector<size_t> greedy_degree_ordering(const elimination_graph& g)
+{
+  elimination_graph h(g);
+  std::vector<size_t> result;
+  greedy_degree_destructive(h, &result);
+  return result;
+}
+
+/// \brief Elimination ordering of greedy fill-in on g.
+inline
+std::vector<size_t> greedy_fill_in_ordering(const elimination_graph& g)
+{
+  elimination_graph h(g);
+  std::vector<size_t> result;
+  greedy_fill_in_destructive(h, &result);
+  return result;
+}
+
+/* \brief Pieces of g, largest first, such that the treewidth of g is the
+ *        maximum of the treewidths of the pieces: its biconnected
+ *        components, split further into atoms if clique_separators is set.
+ *
+ * Vertices without edges are in no piece. The atoms are found from the
+ * minimal elimination ordering of MCS-M, which takes O(nm) time per
+ * biconnected component.
+ */
+inline
+std::vector<graph_piece> treewidth_pieces(const elimination_graph& g, bool clique_separators)
+{
+  std::vector<graph_piece> result = biconnected_components(g);
+  if(clique_separators)
+  {
+    cpplog(cpplogging::verbose) << "Computing clique separators" << std::endl;
+    std::vector<std::vector<graph_piece> > atoms(result.size());
+    parallel_for(0, result.size(), [&](size_t i, size_t)
+    {
+      atoms[i] = clique_separator_atoms(result[i], mcs_m_ordering(result[i].graph));
+    });
+    result.clear();
+    for(std::vector<graph_piece>& a: atoms)
+      result.insert(result.end(), a.begin(), a.end());
+  }
+  std::stable_sort(result.begin(), result.end(),
+      [](const graph_piece& x, const graph_piece& y) { return x.graph.num_vertices() > y.graph.num_vertices(); });
+  return result;
+}
+
+/// \brief Whether pieces consists of a single piece that covers g.
+inline
+bool single_piece(const elimination_graph& g, const std::vector<graph_piece>& pieces)
+{
+  return pieces.size() == 1 && pieces.front().vertices.size() == g.num_vertices();
 }
 
+/// \brief Ordering of a piece, in the numbering of the original graph.
+inline
+std::vector<size_t> original_ordering(const graph_piece& piece, const std::vector<size_t>& ordering)
+{
+  std::vector<size_t> result;
+  result.reserve(ordering.size());
+  for(size_t x: ordering)
+    result.push_back(piece.vertices[x]);
+  return result;
+}
+
+/* \brief Add the fill-in of ordering on piece to fill, in the numbering of
+ *        the original graph.
+ * \return the width of ordering.
+ */
+inline
+size_t piece_fill_in(const graph_piece& piece, const std::vector<size_t>& ordering, std::vector<piece_edge>& fill)
+{
+  elimination_graph h(piece.graph);
+  size_t width = 0;
+  for(size_t x: ordering)
+  {
+    width = std::max(width, h.degree(x));
+    h.eliminate(x, [](size_t) {},
+        [&](size_t u, size_t w) { fill.push_back(piece_edge(piece.vertices[u], piece.vertices[w])); });
+  }
+  return width;
+}
+
+/* \brief Elimination ordering of g, given the fill-in of elimination
+ *        orderings of all pieces of g, of width the maximum of their widths.
+ *
+ * The pieces are glued along cliques, so adding the fill-in of all pieces to
+ * g gives a chordal graph whose maximal cliques are those of the triangulated
+ * pieces; MCS yields a perfect elimination ordering of that graph.
+ */
+inline
+std::vector<size_t> chordal_ordering(const elimination_graph& g, const std::vector<std::vector<piece_edge> >& fill)
+{
+  std::vector<piece_edge> edges;
+  for(size_t v = 0; v < g.universe(); ++v)
+  {
+    for(csr_vertex_t w: g.neighbours(v))
+    {
+      if(v < w)
+        edges.push_back(piece_edge(v, w));
+    }
+  }
+  for(const std::vector<piece_edge>& f: fill)
+    edges.insert(edges.end(), f.begin(), f.end());
+  elimination_graph filled(g.universe(), edges);
+  for(size_t v = 0; v < g.universe(); ++v)
+  {
+    if(g.removed(v))
+      filled.remove(v, [](size_t) {});
+  }
+  return mcs_ordering(filled);
+}
+
+/// \brief Elimination ordering of g from elimination orderings of all pieces
+///        of g, of width the maximum of their widths.
+inline
+std::vector<size_t> combine_orderings(const elimination_graph& g, const std::vector<graph_piece>& pieces,
+                                      const std::vector<std::vector<size_t> >& orderings)
+{
+  if(single_piece(g, pieces))
+    return original_ordering(pieces.front(), orderings.front());
+  std::vector<std::vector<piece_edge> > fill(pieces.size());
+  parallel_for(0, pieces.size(), [&](size_t i, size_t) { piece_fill_in(pieces[i], orderings[i], fill[i]); });
+  return chordal_ordering(g, fill);
+}
+
+/* \brief Elimination ordering of g from heuristic(piece) for all pieces of
+ *        g, which are handled in parallel, largest first.
+ *
+ * A piece with n vertices has treewidth at most n - 1; if that does not
+ * exceed the largest width found so far, the heuristic is skipped and the
+ * piece is ordered by MCS, which takes linear time.
+ */
+template <typename Heuristic>
+inline
+std::vector<size_t> piecewise_ordering(const elimination_graph& g, const std::vector<graph_piece>& pieces, Heuristic heuristic)
+{
+  if(single_piece(g, pieces))
+    return original_ordering(pieces.front(), heuristic(pieces.front().graph));
+
+  std::atomic<size_t> width(0);
+  std::vector<std::vector<piece_edge> > fill(pieces.size());
+  parallel_for(0, pieces.size(), [&](size_t i, size_t)
+  {
+    const elimination_graph& piece = pieces[i].graph;
+    const bool skip = piece.num_vertices() <= width.load() + 1;
+    const std::vector<size_t> ordering = skip ? mcs_ordering(piece) : heuristic(piece);
+    const size_t w = piece_fill_in(pieces[i], ordering, fill[i]);
+    if(!skip)
+      atomic_max(width, w);
+  });
+  return chordal_ordering(g, fill);
+}
+
+} // namespace detail
+
 template <typename UndirectedGraph>
 inline
 typename boost::graph_traits<UndirectedGraph>::vertices_size_type
-greedy_degree(UndirectedGraph g)
+greedy_degree(const UndirectedGraph& g)
 {
-  UndirectedGraph destructable_g;
-  boost::copy_graph(g, destructable_g);
-  return detail::greedy_degree_destructive(destructable_g);
+  elimination_graph destructable_g(g);
+  const size_t low = detail::reduce_destructive(destructable_g);
+  return std::max(low, detail::greedy_degree_destructive(destructable_g));
+}
+
+template <typename UndirectedGraph>
+inline
+typename boost::graph_traits<UndirectedGraph>::vertices_size_type
+greedy_fill_in(const UndirectedGraph& g)
+{
+  elimination_graph destructable_g(g);
+  const size_t low = detail::reduce_destructive(destructable_g);
+  return std::max(low, detail::greedy_fill_in_destructive(destructable_g));
+}
+
+/// \brief Upper bound on treewidth obtained by a heuristic, together with
+///        the elimination ordering that achieves it.
+struct treewidth_upper_bound_t
+{
+  std::string method;
+  size_t width;
+  std::vector<size_t> ordering;
+};
+
+namespace detail
+{
+
+/* \brief Upper bounds on the treewidth of r.graph by all elimination
+ *        ordering heuristics; see treewidth_upper_bounds below.
+ */
+inline
+std::vector<treewidth_upper_bound_t> treewidth_upper_bounds(const treewidth_reduction& r, bool expensive, bool clique_separators)
+{
+  const elimination_graph& kernel = r.kernel;
+  const std::vector<size_t>& reduced = r.reduced;
+  const std::vector<graph_piece> pieces = treewidth_pieces(kernel, clique_separators && expensive);
+
+  std::vector<treewidth_upper_bound_t> result;
+  const auto add = [&](const std::string& method, const std::vector<size_t>& kernel_ordering)
+  {
+    std::vector<size_t> ordering(reduced);
+    ordering.insert(ordering.end(), kernel_ordering.begin(), kernel_ordering.end());
+    elimination_graph h(r.graph);
+    treewidth_upper_bound_t bound = { method, elimination_width_destructive(h, ordering), ordering };
+    result.push_back(bound);
+  };
+
+  add("Greedy degree", piecewise_ordering(kernel, pieces, greedy_degree_ordering));
+  if(expensive)
+    add("Greedy fill-in", piecewise_ordering(kernel, pieces, greedy_fill_in_ordering));
+  add("LexBFS", piecewise_ordering(kernel, pieces, lex_bfs_ordering));
+  add("MCS", piecewise_ordering(kernel, pieces, mcs_ordering));
+  if(expensive)
+    add("MCS-M", piecewise_ordering(kernel, pieces, mcs_m_ordering));
+  return result;
+}
+
+} // namespace detail
+
+/* \brief Upper bounds on the treewidth of (the undirected graph underlying)
+ *        g by all elimination ordering heuristics.
+ *
+ * The heuristics only order the kernel left by the safe reduction rules;
+ * every ordering starts with the vertices eliminated by those rules. The
+ * kernel is split into biconnected components, and if clique_separators is
+ * set, further into atoms; the heuristics run on these pieces separately,
+ * and their orderings are combined into one for the whole graph. The
+ * heuristics that take more than near-linear time, greedy fill-in and MCS-M,
+ * and the splitting into atoms, are only run if expensive is set.
+ */
+template <typename Graph>
+inline
+std::vector<treewidth_upper_bound_t> treewidth_upper_bounds(const Graph& g, bool expensive = true, bool clique_separators = false)
+{
+  return detail::treewidth_upper_bounds(treewidth_reduction(g), expensive, clique_separators);
+}
+
+/// \brief treewidth_upper_bounds of a graph that was reduced already.
+inline
+std::vector<treewidth_upper_bound_t> treewidth_upper_bounds(const treewidth_reduction& r, bool expensive = true,
+                                                            bool clique_separators = false)
+{
+  return detail::treewidth_upper_bounds(r, expensive, clique_separators);
+}
+
+/// \brief The bound in bounds with the smallest width; the first one on ties.
+inline
+const treewidth_upper_bound_t& best_upper_bound(const std::vector<treewidth_upper_bound_t>& bounds)
+{
+  assert(!bounds.empty());
+  return *std::min_element(bounds.begin(), bounds.end(),
+      [](const treewidth_upper_bound_t& x, const treewidth_upper_bound_t& y) { return x.width < y.width; });
+}
+
+/* \brief Anytime upper bound on the treewidth of r.graph by randomized
+ *        restarts, until b is exhausted.
+ *
+ * Like treewidth_upper_bounds, the restarts only order r.kernel. They start
+ * from start, typically the best bound of treewidth_upper_bounds(r), so the
+ * result is never worse than that bound. Restarts take turns running greedy degree, MCS and, if expensive is set,
+ * greedy fill-in. The first turn breaks ties as these heuristics normally
+ * do on the whole kernel; later turns break ties randomly. Every thread
+ * reuses one elimination graph, into which the kernel is copied at the
+ * start of each of its restarts.
+ */
+inline
+anytime_upper_bound_t anytime_treewidth_upper_bound(const treewidth_reduction& r, const treewidth_upper_bound_t& start,
+                                                    budget& b, bool expensive = true)
+{
+  cpplog(cpplogging::verbose) << "Computing anytime treewidth upper bound" << std::endl;
+  const elimination_graph& kernel = r.kernel;
+  const std::vector<size_t>& reduced = r.reduced;
+  const size_t low = r.lower_bound;
+  std::vector<elimination_graph> graphs(num_threads(), kernel);
+  const size_t heuristics = expensive ? 3 : 2;
+  return anytime_upper_bound([&](size_t seed, size_t thread, std::vector<size_t>& ordering)
+  {
+    elimination_graph& h = graphs[thread];
+    h = kernel;
+    std::mt19937 generator(seed);
+    std::mt19937* random = seed < heuristics ? 0 : &generator;
+    ordering = reduced;
+    size_t width;
+    switch(seed % heuristics)
+    {
+      case 0:
+        width = detail::greedy_degree_destructive(h, &ordering, random);
+        break;
+      case 1:
+      {
+        const std::vector<size_t> kernel_ordering = detail::maximum_cardinality_search(kernel, random);
+        width = detail::elimination_width_destructive(h, kernel_ordering);
+        ordering.insert(ordering.end(), kernel_ordering.begin(), kernel_ordering.end());
+        break;
+      }
+      default:
+        width = detail::greedy_fill_in_destructive(h, &ordering, random);
+    }
+    return std::max(low, width);
+  }, b, start.width, start.ordering);
+}
+
+/// \brief Anytime upper bound on the treewidth of (the undirected graph
+///        underlying) g, starting from the best bound of
+///        treewidth_upper_bounds.
+template <typename Graph>
+inline
+anytime_upper_bound_t anytime_treewidth_upper_bound(const Graph& g, budget& b, bool expensive = true)
+{
+  const treewidth_reduction r(g);
+  const treewidth_upper_bound_t start = best_upper_bound(treewidth_upper_bounds(r, expensive));
+  return anytime_treewidth_upper_bound(r, start, b, expensive);
 }
 
 /* Known algorithms for computing lowerbound on treewidth:
  * - MinDegree
- * - MinorMinWidth *  ---
+ * - MinorMinWidth *  --- (equals MaximumMinimumDegreePlusMinD)
  * - Ramachandramurthi
  * - MaximumMinimumDegree *
  * - MaximumMinimumDegreePlusMinD
  * - MaximumMinimumDegreePlusMaxD
  * - MaximumMinimumDegreePlusLeastC *
  * the algorithms marked with * can be started from each vertex.
+ * See H.L. Bodlaender and A.M.C.A. Koster, "Treewidth computations II.
+ * Lower bounds", Information and Computation 209(7), 2011.
  */
 
+/// \brief What to do with a vertex of minimum degree in the degeneracy
+///        lower bounds.
+enum degeneracy_strategy
+{
+  delete_vertex,        ///< delete it (MMD)
+  contract_min_degree,  ///< contract it into a neighbour of minimum degree (MMD+ min-d)
+  contract_max_degree,  ///< contract it into a neighbour of maximum degree (MMD+ max-d)
+  contract_least_common ///< contract it into a neighbour with the fewest common neighbours (MMD+ least-c)
+};
+
+/// \brief Lower bound on treewidth obtained by a heuristic.
+struct treewidth_lower_bound_t
+{
+  std::string method;
+  size_t width;
+  bool complete; ///< false if the budget ran out before the method finished
+};
+
 namespace detail
 {
 
-/* \brief Contract the edge u -- v.
- *
- * The vertex in {u,v} with least outdegree is removed from g. Suppose this is u,
- * then all edges incident to u, that do not introduce a selfloop when moved to
- * v are added to v, and the vertex u is removed from g.
- */
-template <typename UndirectedGraph, class PriorityQueue, class HandleMap>
-inline
-void contract_edge(typename boost::graph_traits<UndirectedGraph>::vertex_descriptor u,
-                   typename boost::graph_traits<UndirectedGraph>::vertex_descriptor v,
-                   UndirectedGraph& g,
-                   PriorityQueue& pq,
-                   HandleMap& handle)
-{
-  // ensure u is the vertex with largest number of neighbours
-  assert(boost::out_degree(v, g) <= boost::out_degree(u,g));
-
-  cpplog(cpplogging::debug, "contract_edge") << "u = " << u << ", v = " << v << " out-degrees " << boost::out_degree(u,g) << ", " << boost::out_degree(v,g) << std::endl;
-  cpplog(cpplogging::debug, "contract_edge") << "removing " << u << "--" << v << std::endl;
-  boost::remove_edge(u, v, g);
-
-  // add all edges of v to u
-  // need while loop here to prevent invalidation of ai iterator before
-  // incrementing.
-  typename boost::graph_traits<UndirectedGraph>::adjacency_iterator ai, aend;
-  boost::tie(ai, aend) = boost::adjacent_vertices(v, g);
-  bool decrease_u = (ai != aend); // if we have got edges left, then we add additional edges to u,
-  // so its outdegree increases, otherwise it decreases because u was v's only neighbour.
-  while(ai != aend)
-  {
-    typename boost::graph_traits<UndirectedGraph>::vertex_descriptor w = *(ai++);
-    assert(w != v); // no self loops
-    assert(w != u); // u -- v was already removed, and we have no multi-edges
-    cpplog(cpplogging::debug, "contract_edge") << "adding " << u << "--" << *ai << std::endl;
-    boost::remove_edge(v, w, g);
-
-    if(!boost::add_edge(u, w, g).second)
+/// \brief The neighbour of v into which v is contracted by strategy; ties
+///        are broken by the smallest number.
+inline
+size_t contraction_target(const elimination_graph& g, size_t v, degeneracy_strategy strategy)
+{
+  const std::vector<csr_vertex_t>& neighbours = g.neighbours(v);
+  size_t result = neighbours.front();
+  size_t best = std::numeric_limits<size_t>::max();
+  for(csr_vertex_t u: neighbours)
+  {
+    size_t score;
+    if(strategy == contract_min_degree)
+      score = g.degree(u);
+    else if(strategy == contract_max_degree)
+      score = g.universe() - g.degree(u);
+    else
+      score = intersection_size(neighbours.data(), neighbours.data() + neighbours.size(),
+                                g.neighbours(u).data(), g.neighbours(u).data() + g.degree(u));
+    if(score < best)
     {
-      pq.increase(handle[w]);
+      best = score;
+      result = u;
     }
-
-    cpplog(cpplogging::debug, "contract_edge") << "removing " << v << "--" << w << std::endl;
   }
-  // trick because increase is more efficient than decrease.
-  if(decrease_u)
-    pq.decrease(handle[u]);
-  else
-    pq.increase(handle[u]);
-
-  assert(boost::out_degree(v,g) == 0);
-  assert(boost::num_edges(g) == 0 || boost::out_degree(u,g) > 0);
+  return result;
 }
 
-/* \brief Determine lowerbound on treewidth through Minor-Min-Width algorithm.
+/* \brief Degeneracy lower bound: the maximum of the minimum degrees of a
+ *        sequence of minors of g; g is destroyed.
+ *
+ * Every minor is obtained from the previous one by deleting or contracting
+ * (depending on strategy) a vertex of minimum degree, or vertex start in the
+ * first step if it is given. Every minor has treewidth at most that of g,
+ * and at least its minimum degree. Isolated vertices are removed first, as
+ * they only lower the minimum degree.
  *
- * Pseudo code:
+ * With strategy contract_min_degree this is the Minor-Min-Width algorithm:
  * 1. lb=0;
  * 2. Repeat
  *   (a) Contract the edge between a minimum degree
@@ -222,71 +992,156 @@ void contract_edge(typename boost::graph_traits<UndirectedGraph>::vertex_descrip
  * 3. Until no vertices remain in g.
  * 4. return lb
  */
-template <typename UndirectedGraph>
 inline
-typename boost::graph_traits<UndirectedGraph>::vertices_size_type
-minor_min_width_destructive(UndirectedGraph& g)
+size_t degeneracy_destructive(elimination_graph& g, degeneracy_strategy strategy,
+                              size_t start = std::numeric_limits<size_t>::max())
 {
-  typedef typename boost::graph_traits<UndirectedGraph>::vertices_size_type vertex_size_t;
-  typedef typename boost::graph_traits<UndirectedGraph>::vertex_descriptor vertex_t;
+  bucket_queue queue(g.universe(), g.universe());
+  for(size_t v = 0; v < g.universe(); ++v)
+  {
+    if(!g.removed(v))
+      queue.push(v, g.degree(v));
+  }
 
-  cpplog(cpplogging::verbose) << "Computing Minor-Min-Width" << std::endl;
-  cpplog(cpplogging::debug) << "Removing self loops" << std::endl;
+  size_t lowerbound = 0;
+  const auto update = [&](size_t w) { queue.update(w, g.degree(w)); };
+  while(g.num_edges() > 0)
+  {
+    while(queue.min_key() == 0)
+      g.remove(queue.pop(), update);
+    lowerbound = std::max(lowerbound, queue.min_key());
 
-  remove_selfloops(g);
+    size_t v;
+    if(start < g.universe() && queue.contains(start))
+      v = start;
+    else
+      v = queue.top();
+    start = std::numeric_limits<size_t>::max();
+    queue.erase(v);
+    cpplog(cpplogging::debug) << "lowerbound = " << lowerbound << ", removing " << v << " with degree " << g.degree(v) << std::endl;
 
-  // build priority queue and record handles
-  typedef outdegree_greater<UndirectedGraph> cmp_t;
-  typedef boost::heap::fibonacci_heap<vertex_t, boost::heap::compare<cmp_t> > priority_queue_t;
-  typedef typename priority_queue_t::handle_type handle_t;
-  cmp_t cmp(g);
-  priority_queue_t pq(cmp);
-  std::vector<handle_t> handles;
+    if(strategy == delete_vertex)
+      g.remove(v, update);
+    else
+      g.contract(contraction_target(g, v, strategy), v, update);
+  }
+  return lowerbound;
+}
 
-  typename boost::graph_traits<UndirectedGraph>::vertex_iterator i, end;
-  for(boost::tie(i,end) = boost::vertices(g); i != end; ++i)
+/// \brief Minimum degree of a vertex of g; a trivial lower bound.
+inline
+size_t min_degree(const elimination_graph& g)
+{
+  size_t result = std::numeric_limits<size_t>::max();
+  for(size_t v = 0; v < g.universe(); ++v)
   {
-    handles.push_back(pq.push(*i));
+    if(!g.removed(v))
+      result = std::min(result, g.degree(v));
   }
+  return g.num_vertices() == 0 ? 0 : result;
+}
 
-  cpplogging::progress_meter progress(boost::num_vertices(g));
-
-  // Determine lowerbound according to minor min-width strategy
-  cpplog(cpplogging::debug) << "init: lowerbound = 0" << std::endl;
-  vertex_size_t lowerbound = 0;
+/* \brief Lower bound of S. Ramachandramurthi, "The Structure and Number of
+ *        Obstructions to Treewidth", SIAM J. Discrete Math. 10(1), 1997:
+ *        the minimum over all non-adjacent pairs v, w of the larger of their
+ *        degrees, or n - 1 for a complete graph.
+ *
+ * Vertices are visited by increasing degree; the best partner of v is the
+ * first vertex in that order that is not adjacent to v, so finding it takes
+ * time linear in the degree of v.
+ */
+inline
+size_t ramachandramurthi(const elimination_graph& g)
+{
+  if(g.num_vertices() == 0)
+    return 0;
+  std::vector<size_t> order;
+  for(size_t v = 0; v < g.universe(); ++v)
+  {
+    if(!g.removed(v))
+      order.push_back(v);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return g.degree(x) < g.degree(y); });
 
-  while(!pq.empty())
+  size_t result = g.num_vertices() - 1;
+  std::vector<char> adjacent(g.universe(), 0);
+  for(size_t v: order)
   {
-    progress.step();
-    if(boost::num_edges(g) == 0)
-      return lowerbound;
-
-    vertex_t u = pq.top();
-    pq.pop();
-    vertex_size_t degree_u = boost::out_degree(u, g);
-    assert(degree_u > 0);
-    cpplog(cpplogging::debug) << "top element of queue: " << u << " with out-degree " << degree_u << std::endl;
-
-    lowerbound = std::max(degree_u, lowerbound);
-    cpplog(cpplogging::debug) << "lowerbound = " << lowerbound << std::endl;
-
-    vertex_t v = vertex_t(); // v is always overwritten in the loop, silence warning
-    vertex_size_t degree_v = std::numeric_limits<vertex_size_t>::max();
-    typename boost::graph_traits<UndirectedGraph>::adjacency_iterator ai, aend;
-    for (boost::tie(ai, aend) = boost::adjacent_vertices(u, g); ai != aend; ++ai)
+    if(g.degree(v) >= result)
+      break;
+    for(csr_vertex_t u: g.neighbours(v))
+      adjacent[u] = 1;
+    for(size_t w: order)
     {
-      vertex_size_t n = boost::out_degree(*ai, g);
-      if(n < degree_v && n > 0)
+      if(w != v && !adjacent[w])
       {
-        degree_v = n;
-        v = *ai;
+        result = std::min(result, std::max(g.degree(v), g.degree(w)));
+        break;
       }
     }
-    cpplog(cpplogging::debug) << "neighbour with minimal outdegree: " << v << " with out-degree " << degree_v << std::endl;
-    contract_edge(v, u, g, pq, handles);
+    for(csr_vertex_t u: g.neighbours(v))
+      adjacent[u] = 0;
   }
-  return lowerbound;
+  return result;
+}
+
+/* \brief Maximum of the degeneracy bounds with strategy over all start
+ *        vertices, computed in parallel.
+ *
+ * Every start vertex takes one step of budget b; once it runs out, the
+ * remaining start vertices are skipped, which still gives a lower bound,
+ * and complete is cleared.
+ */
+inline
+size_t degeneracy_all_starts(const elimination_graph& g, degeneracy_strategy strategy, budget& b, bool& complete)
+{
+  std::atomic<size_t> result(0);
+  std::atomic<bool> skipped(false);
+  parallel_for(0, g.universe(), [&](size_t start, size_t)
+  {
+    if(g.removed(start))
+      return;
+    if(b.exhausted() || !b.step())
+    {
+      skipped.store(true);
+      return;
+    }
+    elimination_graph h(g);
+    atomic_max(result, degeneracy_destructive(h, strategy, start));
+  }, 1);
+  if(skipped.load())
+    complete = false;
+  return result.load();
+}
+
+/* \brief Maximum of low and bound(piece) over all pieces, which are handled
+ *        largest first, and in parallel if parallel is set.
+ *
+ * A piece with n vertices has treewidth at most n - 1; if that does not
+ * exceed the maximum found so far, the piece cannot raise it, and bound is
+ * not computed.
+ */
+template <typename Bound>
+inline
+size_t piecewise_lower_bound(const std::vector<graph_piece>& pieces, size_t low, Bound bound, bool parallel = true)
+{
+  std::atomic<size_t> result(low);
+  const auto run = [&](size_t i, size_t)
+  {
+    const elimination_graph& piece = pieces[i].graph;
+    if(piece.num_vertices() > result.load() + 1)
+      atomic_max(result, bound(piece));
+  };
+  if(parallel)
+    parallel_for(0, pieces.size(), run);
+  else
+  {
+    for(size_t i = 0; i < pieces.size(); ++i)
+      run(i, 0);
+  }
+  return result.load();
 }
+
 } // namespace detail
 
 template <typename UndirectedGraph>
@@ -294,15 +1149,447 @@ inline
 typename boost::graph_traits<UndirectedGraph>::vertices_size_type
 minor_min_width(const UndirectedGraph& g)
 {
-  UndirectedGraph destructable_g;
-  boost::copy_graph(g, destructable_g);
-  return detail::minor_min_width_destructive(destructable_g);
+  cpplog(cpplogging::verbose) << "Computing Minor-Min-Width" << std::endl;
+  elimination_graph destructable_g(g);
+  const size_t low = detail::reduce_destructive(destructable_g);
+  return std::max(low, detail::degeneracy_destructive(destructable_g, contract_min_degree));
+}
+
+namespace detail
+{
+
+/* \brief Lower bounds on the treewidth of r.graph by all heuristics; see
+ *        treewidth_lower_bounds below.
+ */
+inline
+std::vector<treewidth_lower_bound_t> treewidth_lower_bounds(const treewidth_reduction& r, bool expensive, budget* b, bool clique_separators)
+{
+  cpplog(cpplogging::verbose) << "Computing lower bounds on treewidth" << std::endl;
+  const elimination_graph& kernel = r.kernel;
+  const size_t low = r.lower_bound;
+  const std::vector<graph_piece> pieces = treewidth_pieces(kernel, clique_separators && expensive);
+  std::vector<treewidth_lower_bound_t> result;
+  const auto add = [&](const std::string& method, size_t width, bool complete)
+  {
+    treewidth_lower_bound_t bound = { method, width, complete };
+    result.push_back(bound);
+  };
+  const auto degeneracy = [&](degeneracy_strategy strategy)
+  {
+    return piecewise_lower_bound(pieces, low, [&](const elimination_graph& piece)
+    {
+      elimination_graph h(piece);
+      return degeneracy_destructive(h, strategy);
+    });
+  };
+
+  const size_t min_d = degeneracy(contract_min_degree);
+  const size_t least_c = degeneracy(contract_least_common);
+  add("MinDegree", piecewise_lower_bound(pieces, low, min_degree), true);
+  add("Ramachandramurthi", piecewise_lower_bound(pieces, low, ramachandramurthi), true);
+  add("MMD", degeneracy(delete_vertex), true);
+  add("MMD+ (min-d)", min_d, true);
+  add("MMD+ (max-d)", degeneracy(contract_max_degree), true);
+  add("MMD+ (least-c)", least_c, true);
+  if(expensive)
+  {
+    // Every run is parallel over start vertices already. Starting from the
+    // bound of the default start vertex, a run that is cut short by the
+    // budget is never worse than that bound.
+    budget unlimited;
+    budget& starts = b ? *b : unlimited;
+    const auto all_starts = [&](const std::string& method, degeneracy_strategy strategy, size_t single)
+    {
+      bool complete = true;
+      const size_t width = piecewise_lower_bound(pieces, single,
+          [&](const elimination_graph& piece) { return degeneracy_all_starts(piece, strategy, starts, complete); }, false);
+      add(method, width, complete);
+    };
+    all_starts("MMD+ (min-d, all starts)", contract_min_degree, min_d);
+    all_starts("MMD+ (least-c, all starts)", contract_least_common, least_c);
+  }
+  return result;
+}
+
+} // namespace detail
+
+/* \brief Lower bounds on the treewidth of (the undirected graph underlying)
+ *        g by all heuristics.
+ *
+ * The contraction degeneracy bounds started from every vertex take
+ * quadratic time, and are only computed if expensive is set; the runs for
+ * different start vertices are independent and done in parallel. MMD is not
+ * started from every vertex, as it already equals the maximal minimum degree
+ * over all subgraphs (the degeneracy of g). These runs are also limited by
+ * budget b, if given; a run that the budget cut short is marked incomplete,
+ * and is never below the bound of the same strategy from the default start
+ * vertex.
+ *
+ * All heuristics run on the kernel left by the safe reduction rules, and
+ * every bound is at least the lower bound certified by those rules. The
+ * kernel is split into biconnected components, and if clique_separators is
+ * set (and expensive), further into atoms; every bound is the maximum of the
+ * bounds of the pieces, which are computed in parallel, largest first.
+ */
+template <typename Graph>
+inline
+std::vector<treewidth_lower_bound_t> treewidth_lower_bounds(const Graph& g, bool expensive = true, budget* b = 0,
+                                                            bool clique_separators = false)
+{
+  return detail::treewidth_lower_bounds(treewidth_reduction(g), expensive, b, clique_separators);
+}
+
+/// \brief treewidth_lower_bounds of a graph that was reduced already.
+inline
+std::vector<treewidth_lower_bound_t> treewidth_lower_bounds(const treewidth_reduction& r, bool expensive = true, budget* b = 0,
+                                                            bool clique_separators = false)
+{
+  return detail::treewidth_lower_bounds(r, expensive, b, clique_separators);
+}
+
+/// \brief The bound in bounds with the largest width; the first one on ties.
+inline
+const treewidth_lower_bound_t& best_lower_bound(const std::vector<treewidth_lower_bound_t>& bounds)
+{
+  assert(!bounds.empty());
+  return *std::max_element(bounds.begin(), bounds.end(),
+      [](const treewidth_lower_bound_t& x, const treewidth_lower_bound_t& y) { return x.width < y.width; });
 }
 
 /* Exact algorithms known for computing treewidth:
  * - QuickBB
  * - TreewidthDP
+ *
+ * QuickBB (V. Gogate and R. Dechter, "A Complete Anytime Algorithm for
+ * Treewidth", UAI 2004) is implemented below, as a sequence of decision
+ * problems: for increasing k, starting from the best lower bound, a
+ * depth-first search looks for an elimination ordering of width at most k.
+ * A branch is cut off as soon as the Minor-Min-Width bound of the remaining
+ * graph exceeds k. The graph that remains after eliminating a set S does not
+ * depend on the order in which S was eliminated, so the sets for which the
+ * search failed are memoised. Simplicial vertices, and almost simplicial
+ * vertices of degree at most k, are eliminated without branching; the
+ * latter is safe because the result is a minor of the graph.
  */
 
+struct exact_treewidth_t
+{
+  size_t lower_bound;
+  size_t upper_bound;
+  bool complete;              ///< whether lower_bound == upper_bound is the treewidth
+  size_t nodes;               ///< number of search nodes visited
+  std::vector<size_t> ordering; ///< elimination ordering of width upper_bound
+
+  exact_treewidth_t()
+    : lower_bound(0), upper_bound(0), complete(false), nodes(0)
+  {}
+};
+
+namespace detail
+{
+
+/// \brief Memory that may be used for memoising failed sets of eliminated
+///        vertices.
+const size_t treewidth_memo_budget = size_t(256) << 20;
+
+struct vertex_bits_hash
+{
+  size_t operator()(const std::vector<uint64_t>& bits) const
+  {
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for(uint64_t w: bits)
+      h = (h ^ w) * 0xff51afd7ed558ccdULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+};
+
+class treewidth_search
+{
+protected:
+  typedef std::vector<uint64_t> vertex_bits;
+
+  size_t m_k;
+  budget& m_budget;
+  std::atomic<bool> m_found;
+  std::atomic<bool> m_aborted;
+  std::atomic<size_t> m_nodes;
+  std::mutex m_mutex;
+  std::unordered_set<vertex_bits, vertex_bits_hash> m_failed;
+  size_t m_max_failed;
+  std::vector<size_t> m_ordering;
+
+  static void insert(vertex_bits& s, size_t v)
+  {
+    s[v/64] |= uint64_t(1) << (v % 64);
+  }
+
+  bool known_failure(const vertex_bits& s)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed.find(s) != m_failed.end();
+  }
+
+  void record_failure(const vertex_bits& s)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_failed.size() < m_max_failed)
+      m_failed.insert(s);
+  }
+
+  void record_success(const std::vector<size_t>& path, const elimination_graph& g)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_found.exchange(true))
+      return;
+    m_ordering = path;
+    for(size_t v = 0; v < g.universe(); ++v)
+    {
+      if(!g.removed(v))
+        m_ordering.push_back(v);
+    }
+  }
+
+  bool stopped() const
+  {
+    return m_found.load(std::memory_order_relaxed) || m_aborted.load(std::memory_order_relaxed);
+  }
+
+  /* \brief Eliminate simplicial and almost simplicial vertices of degree at
+   *        most k until there are none.
+   * \return false if g contains a simplicial vertex of degree more than k,
+   *         hence a clique of more than k + 1 vertices.
+   */
+  bool reduce(elimination_graph& g, vertex_bits& s, std::vector<size_t>& path)
+  {
+    bool progress = true;
+    while(progress)
+    {
+      progress = false;
+      for(size_t v = 0; v < g.universe(); ++v)
+      {
+        if(g.removed(v))
+          continue;
+        bool almost;
+        size_t other;
+        const bool is_simplicial = simplicial(g, v, almost, other);
+        if(is_simplicial && g.degree(v) > m_k)
+          return false;
+        if((is_simplicial || almost) && g.degree(v) <= m_k)
+        {
+          g.eliminate(v, [](size_t) {});
+          insert(s, v);
+          path.push_back(v);
+          progress = true;
+        }
+      }
+    }
+    return true;
+  }
+
+  /// \brief Candidates for the next vertex to eliminate, by increasing
+  ///        degree.
+  std::vector<size_t> candidates(const elimination_graph& g) const
+  {
+    std::vector<size_t> result;
+    for(size_t v = 0; v < g.universe(); ++v)
+    {
+      if(!g.removed(v) && g.degree(v) <= m_k)
+        result.push_back(v);
+    }
+    std::stable_sort(result.begin(), result.end(), [&](size_t x, size_t y) { return g.degree(x) < g.degree(y); });
+    return result;
+  }
+
+  /* \brief Prepare the search from g with eliminated set s.
+   * \return 1 if an ordering was found, 0 if the search must branch, and -1
+   *         if the search failed or was stopped.
+   */
+  int enter(elimination_graph& g, vertex_bits& s, std::vector<size_t>& path)
+  {
+    if(stopped())
+      return -1;
+    if(m_budget.exhausted() || !m_budget.step())
+    {
+      m_aborted = true;
+      return -1;
+    }
+    ++m_nodes;
+    if(!reduce(g, s, path))
+      return -1;
+    if(g.num_vertices() <= m_k + 1)
+    {
+      record_success(path, g);
+      return 1;
+    }
+    if(known_failure(s))
+      return -1;
+    elimination_graph h(g);
+    if(degeneracy_destructive(h, contract_min_degree) > m_k)
+    {
+      record_failure(s);
+      return -1;
+    }
+    return 0;
+  }
+
+  void search(elimination_graph& g, vertex_bits& s, std::vector<size_t>& path)
+  {
+    const int status = enter(g, s, path);
+    if(status != 0)
+      return;
+    for(size_t v: candidates(g))
+    {
+      elimination_graph h(g);
+      vertex_bits t(s);
+      std::vector<size_t> p(path);
+      h.eliminate(v, [](size_t) {});
+      insert(t, v);
+      p.push_back(v);
+      search(h, t, p);
+      if(stopped())
+        return;
+    }
+    record_failure(s);
+  }
+
+public:
+  treewidth_search(size_t k, budget& b, size_t universe)
+    : m_k(k), m_budget(b), m_found(false), m_aborted(false), m_nodes(0),
+      m_max_failed(treewidth_memo_budget / (8*((universe + 63)/64) + 64))
+  {}
+
+  /* \brief Search for an elimination ordering of width at most k; the
+   *        branches of the root are searched in parallel.
+   * \return 1 if one was found, 0 if there is none, and -1 if the budget ran
+   *         out.
+   */
+  int run(const elimination_graph& g)
+  {
+    elimination_graph root(g);
+    vertex_bits s((g.universe() + 63)/64, 0);
+    std::vector<size_t> path;
+    const int status = enter(root, s, path);
+    if(status == 0)
+    {
+      const std::vector<size_t> first = candidates(root);
+      parallel_for(0, first.size(), [&](size_t i, size_t)
+      {
+        if(stopped())
+          return;
+        elimination_graph h(root);
+        vertex_bits t(s);
+        std::vector<size_t> p(path);
+        h.eliminate(first[i], [](size_t) {});
+        insert(t, first[i]);
+        p.push_back(first[i]);
+        search(h, t, p);
+      });
+    }
+    if(m_found)
+      return 1;
+    return m_aborted ? -1 : 0;
+  }
+
+  size_t nodes() const
+  {
+    return m_nodes.load();
+  }
+
+  const std::vector<size_t>& ordering() const
+  {
+    return m_ordering;
+  }
+};
+
+} // namespace detail
+
+/// \brief exact_treewidth of a graph that was reduced already.
+inline
+exact_treewidth_t exact_treewidth(const treewidth_reduction& r, budget& b)
+{
+  cpplog(cpplogging::verbose) << "Computing exact treewidth" << std::endl;
+  const elimination_graph& kernel = r.kernel;
+  const size_t low = r.lower_bound;
+  const std::vector<graph_piece> pieces = detail::treewidth_pieces(kernel, false);
+
+  exact_treewidth_t result;
+  result.lower_bound = low;
+  result.complete = true;
+  std::vector<std::vector<size_t> > orderings(pieces.size());
+  for(size_t i = 0; i < pieces.size(); ++i)
+  {
+    const elimination_graph& piece = pieces[i].graph;
+    if(piece.num_vertices() <= result.lower_bound + 1)
+    {
+      orderings[i] = detail::mcs_ordering(piece);
+      continue;
+    }
+    // Greedy fill-in and MCS-M take O(nm) time, so they only run while the
+    // budget lasts; the remaining heuristics are near-linear.
+    if(b.exhausted())
+      result.complete = false;
+    const treewidth_upper_bound_t upper = best_upper_bound(detail::treewidth_upper_bounds(treewidth_reduction(piece), result.complete, false));
+    orderings[i] = upper.ordering;
+    if(b.exhausted())
+      result.complete = false;
+    size_t lower = result.lower_bound;
+    if(result.complete)
+      lower = std::max(lower, best_lower_bound(detail::treewidth_lower_bounds(treewidth_reduction(piece), false, 0, false)).width);
+    while(result.complete && lower < upper.width)
+    {
+      cpplog(cpplogging::verbose) << "Searching for an elimination ordering of width " << lower
+                                  << " of a component with " << piece.num_vertices() << " vertices" << std::endl;
+      detail::treewidth_search search(lower, b, piece.universe());
+      const int status = search.run(piece);
+      result.nodes += search.nodes();
+      if(status < 0)
+        result.complete = false;
+      else if(status > 0)
+      {
+        orderings[i] = search.ordering();
+        break;
+      }
+      else
+        ++lower;
+    }
+    result.lower_bound = std::max(result.lower_bound, std::min(lower, upper.width));
+  }
+
+  result.ordering = r.reduced;
+  const std::vector<size_t> ordering = detail::combine_orderings(kernel, pieces, orderings);
+  result.ordering.insert(result.ordering.end(), ordering.begin(), ordering.end());
+  elimination_graph h(r.graph);
+  result.upper_bound = detail::elimination_width_destructive(h, result.ordering);
+  return result;
+}
+
+/* \brief Exact treewidth of (the undirected graph underlying) g, within
+ *        budget b (one step per search node).
+ *
+ * The search runs on the biconnected components of the kernel left by the
+ * safe reduction rules, one at a time, largest first; every search is
+ * parallel. The lower bound is the maximum over the components searched so
+ * far, so a component is only searched if its upper bound exceeds that
+ * maximum, and then only for widths that exceed it. If the budget runs out,
+ * the remaining components are only bounded by the near-linear heuristics,
+ * and the result holds the bounds improved by the search so far, with an
+ * ordering that achieves the upper bound.
+ */
+template <typename Graph>
+inline
+exact_treewidth_t exact_treewidth(const Graph& g, budget& b)
+{
+  return exact_treewidth(treewidth_reduction(g), b);
+}
+
+/// \brief Treewidth of (the undirected graph underlying) g; takes
+///        exponential time in the worst case.
+template <typename Graph>
+inline
+size_t treewidth(const Graph& g)
+{
+  budget unlimited;
+  return exact_treewidth(g, unlimited).upper_bound;
+}
 
 #endif // TREEWIDTH_H
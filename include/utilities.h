@@ -9,8 +9,10 @@
 /// \file /path/to/file.ext
 /// \brief Description comes here
 
+#include <algorithm>
 #include <istream>
 #include <fstream>
+#include <vector>
 
 #ifndef UTILITIES_H
 #define UTILITIES_H
@@ -28,31 +30,17 @@ std::string print(const std::multiset<T>& s)
   return ss.str();
 }
 
+/// \brief Number of distinct values that occur exactly n times in c.
+/// \pre the elements of c are non-negative integers.
 template<typename Container>
-size_t count_elements_occurring_exactly_n_times(Container c, size_t n = 1)
+size_t count_elements_occurring_exactly_n_times(const Container& c, size_t n = 1)
 {
-  std::sort(c.begin(), c.end());
-
-  size_t result = 0;
-  auto i = c.begin();
-  size_t prev = *(i++);
-  size_t count = 1;
-  if(i == c.end())
-    return 1;
-  for(; i != c.end(); ++i)
-  {
-    if(prev == *i)
-      ++count;
-    else
-    {
-      if(count == 1)
-        ++result;
-      count = 1;
-      prev = *i;
-    }
-  }
-  if(count == n) ++result;
-  return result;
+  if(c.empty())
+    return 0;
+  std::vector<size_t> count(*std::max_element(c.begin(), c.end()) + 1, 0);
+  for(auto i = c.begin(); i != c.end(); ++i)
+    ++count[*i];
+  return std::count(count.begin(), count.end(), n);
 }
 
 template<typename key_t>
@@ -0,0 +1,183 @@
+// Author(s): Jeroen Keiren
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file zielonka.h
+/// \brief Profile of the recursive algorithm of W. Zielonka, "Infinite Games
+///        on Finitely Coloured Graphs with Applications to Automata on
+///        Infinite Trees", TCS 200(1-2), 1998.
+///
+/// The shape of the recursion predicts how hard a game is for recursive
+/// solvers. Subgames are represented by bitset masks over the vertices of
+/// the original game; all attractors are computed by a single
+/// attractor_engine.
+
+#ifndef ZIELONKA_H
+#define ZIELONKA_H
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "cpplogging/logger.h"
+#include "attractor.h"
+#include "budget.h"
+#include "csr.h"
+#include "pg.h"
+
+struct zielonka_profile_t
+{
+  size_t recursive_calls; ///< Number of nodes in the recursion tree.
+  size_t max_depth;       ///< Maximal depth of the recursion tree.
+  size_t attractors;      ///< Number of attractor computations.
+  size_t winning[2];      ///< Sizes of the winning regions; only valid if complete.
+  bool complete;          ///< Whether the recursion finished within budget.
+
+  zielonka_profile_t()
+    : recursive_calls(0), max_depth(0), attractors(0), complete(false)
+  {
+    winning[even] = 0;
+    winning[odd] = 0;
+  }
+};
+
+namespace detail
+{
+
+/// \brief Recursion depth beyond which the profile is abandoned, to stay
+///        within the stack.
+const size_t zielonka_max_depth = 10000;
+
+/// \brief Bytes that the vertex sets of all levels of the recursion may
+///        take together; bounds the depth for large games.
+const size_t zielonka_memory_budget = size_t(256) << 20;
+
+class zielonka_recursion
+{
+protected:
+  /// \brief Vertex sets of one level of the recursion, reused by all calls
+  ///        at that depth.
+  struct frame
+  {
+    vertex_set attractor;
+    vertex_set rest;
+    vertex_set sub_won[2];
+
+    explicit frame(size_t n)
+      : attractor(n), rest(n)
+    {
+      sub_won[even] = vertex_set(n);
+      sub_won[odd] = vertex_set(n);
+    }
+  };
+
+  const std::vector<priority_t>& m_prio;
+  attractor_engine& m_engine;
+  budget& m_budget;
+  zielonka_profile_t& m_profile;
+  size_t m_max_depth; ///< depth at which the frames use up the memory budget
+  std::deque<frame> m_frames; ///< deque, so that frames do not move
+
+public:
+  zielonka_recursion(const std::vector<priority_t>& prio, attractor_engine& engine, budget& b, zielonka_profile_t& profile)
+    : m_prio(prio), m_engine(engine), m_budget(b), m_profile(profile),
+      m_max_depth(std::min(zielonka_max_depth, zielonka_memory_budget / (4 * sizeof(uint64_t) * ((prio.size() + 63) / 64) + sizeof(frame))))
+  {}
+
+  /* \brief Solve subgame, setting won[alpha] to the winning region of alpha.
+   * \pre won[even] and won[odd] have the universe of subgame.
+   * \return false if the budget ran out, or the recursion got too deep, in
+   *         which case won is meaningless.
+   */
+  bool solve(const vertex_set& subgame, vertex_set (&won)[2], size_t depth)
+  {
+    if(depth > m_max_depth || m_budget.exhausted() || !m_budget.step())
+      return false;
+    ++m_profile.recursive_calls;
+    m_profile.max_depth = std::max(m_profile.max_depth, depth);
+
+    won[even].clear();
+    won[odd].clear();
+    if(subgame.empty())
+      return true;
+
+    const size_t n = subgame.universe();
+    if(m_frames.size() <= depth)
+      m_frames.push_back(frame(n));
+    frame& f = m_frames[depth];
+
+    priority_t p = 0;
+    subgame.for_each([&](size_t v) { p = std::max(p, m_prio[v]); });
+    const player_t alpha = static_cast<player_t>(p % 2);
+    const player_t beta = static_cast<player_t>(1 - alpha);
+
+    f.attractor.clear();
+    subgame.for_each([&](size_t v) { if(m_prio[v] == p) f.attractor.insert(v); });
+    m_engine.attract(subgame, f.attractor, alpha);
+    ++m_profile.attractors;
+
+    f.rest = subgame;
+    f.rest.subtract(f.attractor);
+    if(!solve(f.rest, f.sub_won, depth + 1))
+      return false;
+
+    if(f.sub_won[beta].empty())
+    {
+      won[alpha] = subgame;
+      return true;
+    }
+
+    // The attractor of alpha is no longer needed; reuse it for beta.
+    f.attractor = f.sub_won[beta];
+    m_engine.attract(subgame, f.attractor, beta);
+    ++m_profile.attractors;
+
+    f.rest = subgame;
+    f.rest.subtract(f.attractor);
+    if(!solve(f.rest, f.sub_won, depth + 1))
+      return false;
+
+    won[alpha] = f.sub_won[alpha];
+    won[beta] = f.sub_won[beta];
+    f.attractor.for_each([&](size_t v) { won[beta].insert(v); });
+    return true;
+  }
+};
+
+} // namespace detail
+
+/* \brief Run Zielonka's algorithm on g within budget b (one step per
+ *        recursive call), and record the shape of the recursion.
+ *
+ * If the budget runs out, the counts describe the part of the recursion
+ * that was explored, and the winning regions are not reported.
+ */
+template <typename Graph>
+inline
+zielonka_profile_t zielonka_profile(const Graph& g, budget& b)
+{
+  cpplog(cpplogging::verbose) << "Computing Zielonka recursion profile" << std::endl;
+  const csr_graph fwd = make_csr(g);
+  const csr_graph bwd = make_reverse_csr(fwd);
+  const size_t n = fwd.num_vertices();
+  std::vector<priority_t> prio(n);
+  for(size_t v = 0; v < n; ++v)
+    prio[v] = g[v].prio;
+
+  attractor_engine engine(g, fwd, bwd);
+  zielonka_profile_t result;
+  detail::zielonka_recursion recursion(prio, engine, b, result);
+  vertex_set won[2] = { vertex_set(n), vertex_set(n) };
+  result.complete = recursion.solve(vertex_set(n, true), won, 0);
+  if(result.complete)
+  {
+    result.winning[even] = won[even].count();
+    result.winning[odd] = won[odd].count();
+  }
+  return result;
+}
+
+#endif // ZIELONKA_H
@@ -5,6 +5,7 @@
 #include "pg.h"
 #include "pgsolver_io.h"
 #include "utilities.h"
+#include "parallel.h"
 #include "report.h"
 
 class pginfo : public tools::input_output_tool
@@ -15,6 +16,8 @@ private:
 
 protected:
   report_options m_options;
+  bool m_renumber_priorities;
+  bool m_compress_priorities;
   typedef tools::input_output_tool super;
 
 public:
@@ -23,7 +26,9 @@ public:
                                         "Jeroen J.A. Keiren",
                                         "Provides various sorts of structural information about parity games.",
                                         "Structural properties that are described in the paper XXX"), // TODO
-      m_options(false)
+      m_options(false),
+      m_renumber_priorities(false),
+      m_compress_priorities(false)
   {}
 
   void
@@ -37,18 +42,58 @@ public:
         add_option("dfs", "compute information from DFS on the graph").
         add_option("diameter", "compute the diameter of the graph").
         add_option("girth", "compute the girth of the graph").
+        add_option("parity-girth", "compute the lengths of the shortest even- and odd-dominated cycles").
         add_option("diamonds", "compute the number of diamonds in the graph").
+        add_option("motifs", "count 2-cycles, directed triangles, stars and diamonds per owner and priority parity").
         add_option("neighbourhoods", make_mandatory_argument<size_t>("NUM"),
                    "compute the sizes of the neighbourhoods up to and including NUM").
-        add_option("treewidth-lb", "compute lowerbound on treewidth").
-        add_option("treewidth-ub", "compute upperbound on treewidth").
+        add_option("approx-neighbourhoods", make_mandatory_argument<size_t>("NUM"),
+                   "estimate the sizes of the neighbourhoods up to and including NUM using HyperLogLog counters").
+        add_option("hll-precision", make_mandatory_argument<size_t>("NUM"),
+                   "use 2^NUM registers per HyperLogLog counter, 4 <= NUM <= 16 (default: 6)").
+        add_option("treewidth-lb", "compute lowerbounds on treewidth using minimum degree, Ramachandramurthi, "
+                   "MMD and the MMD+ variants, and report the best one and its method").
+        add_option("treewidth-ub", "compute upperbounds on treewidth using greedy degree, greedy fill-in, "
+                   "LexBFS, MCS and MCS-M elimination orderings, and report the best one; both this and "
+                   "--treewidth-lb first reduce the graph by safe rules and report the kernel size").
+        add_option("treewidth-td", make_mandatory_argument("FILE"),
+                   "write the elimination ordering with the best upperbound on treewidth, and its tree "
+                   "decomposition, to FILE in PACE .td format, and validate the decomposition; implies "
+                   "--treewidth-ub").
+        add_option("anytime", make_mandatory_argument<size_t>("NUM"),
+                   "improve the upperbounds on treewidth and Kelly-width by up to NUM restarts with random "
+                   "tie-breaking, in parallel, or until the budget runs out, and report the best bound, the "
+                   "number of restarts and the time at which the best bound was found").
+        add_option("clique-separators", "split the graph into atoms along clique separators before bounding "
+                   "treewidth, in addition to biconnected components").
+        add_option("treewidth-exact", "compute treewidth exactly by branch and bound; takes exponential "
+                   "time in the worst case, so it is not part of --all, but may be combined with it").
         add_option("kellywidth-ub", "compute upperbound on Kelly-width").
         add_option("sccs", "compute strongly connected components").
+        add_option("attractors", "compute, for both players, the size and depth of the attractor "
+                   "to the highest priority of their parity").
+        add_option("zielonka", "run Zielonka's recursive algorithm and record the size and depth "
+                   "of its recursion tree, the number of attractor computations and the sizes "
+                   "of the winning regions; takes exponential time in the worst case, so it is "
+                   "not part of --all, but may be combined with it").
         add_option("ad-cks", "compute alternation-depth using the algorithm from [CKS93]").
         add_option("ad", "compute alternation-depth using a sorting of priorities").
+        add_option("ad-nested", "compute alternation-depth by recursively removing the highest "
+                   "priority from every strongly connected component").
         add_option("max-for-expensive", make_mandatory_argument<size_t>("NUM"),
-                    "for BFS and DFS do not records queue or stack sizes if the "
-                    "number of vertices exceeds NUM");
+                    "for BFS and DFS do not records queue or stack sizes, and skip greedy "
+                    "fill-in, MCS-M, clique separators and the treewidth lowerbounds started from every vertex, "
+                    "if the number of vertices exceeds NUM").
+        add_option("budget", make_mandatory_argument<double>("SECONDS"),
+                   "stop budgeted measures (--zielonka, --treewidth-exact, --anytime, and the treewidth "
+                   "lowerbounds started from every vertex) after SECONDS seconds and report "
+                   "partial results (default: unlimited)").
+        add_option("renumber-priorities", "before computing any measure, merge runs of consecutive "
+                   "priorities of the same parity and number them densely").
+        add_option("compress-priorities", "before computing any measure, compress priorities "
+                   "within strongly connected components (Friedmann-Lange); subsumes --renumber-priorities").
+        add_option("threads", make_mandatory_argument<size_t>("NUM"),
+                   "use NUM threads for the parallel measures (default: all hardware threads)");
   }
 
   void parse_options(const command_line_parser& parser)
@@ -65,21 +110,58 @@ public:
       m_options.dfs_info = parser.options.count("dfs");
       m_options.diameter = parser.options.count("diameter");
       m_options.girth = parser.options.count("girth");
+      m_options.parity_girth = parser.options.count("parity-girth");
       m_options.diamonds = parser.options.count("diamonds");
+      m_options.motifs = parser.options.count("motifs");
       m_options.neighbourhoods = parser.options.count("neighbourhoods");
       if(m_options.neighbourhoods)
         m_options.neighbourhoods_upto = parser.option_argument_as<size_t>("neighbourhoods");
+      m_options.approximate_neighbourhoods = parser.options.count("approx-neighbourhoods");
+      if(m_options.approximate_neighbourhoods)
+        m_options.approximate_neighbourhoods_upto = parser.option_argument_as<size_t>("approx-neighbourhoods");
       m_options.treewidth_lowerbound = parser.options.count("treewidth-lb");
       m_options.treewidth_upperbound = parser.options.count("treewidth-ub");
+      m_options.treewidth_clique_separators = parser.options.count("clique-separators");
       m_options.kellywidth_upperbound = parser.options.count("kellywidth-ub");
       m_options.sccs = parser.options.count("sccs");
+      m_options.attractors = parser.options.count("attractors");
       m_options.alternation_depth_cks = parser.options.count("ad-cks");
       m_options.alternation_depth = parser.options.count("ad");
+      m_options.alternation_depth_nested = parser.options.count("ad-nested");
+    }
+    m_options.treewidth_exact = parser.options.count("treewidth-exact");
+    m_options.zielonka = parser.options.count("zielonka");
+    if(parser.options.count("anytime"))
+    {
+      m_options.anytime_restarts = parser.option_argument_as<size_t>("anytime");
+    }
+    if(parser.options.count("treewidth-td"))
+    {
+      m_options.treewidth_decomposition_file = parser.option_argument("treewidth-td");
+      m_options.treewidth_upperbound = true;
     }
     if(parser.options.count("max-for-expensive"))
     {
       m_options.max_vertices_for_expensive_checks = parser.option_argument_as<size_t>("max-for-expensive");
     }
+    if(parser.options.count("budget"))
+    {
+      m_options.budget_seconds = parser.option_argument_as<double>("budget");
+      if(m_options.budget_seconds < 0)
+        throw std::runtime_error("the budget must not be negative");
+    }
+    if(parser.options.count("hll-precision"))
+    {
+      m_options.hyperloglog_precision = parser.option_argument_as<size_t>("hll-precision");
+      if(m_options.hyperloglog_precision < 4 || m_options.hyperloglog_precision > 16)
+        throw std::runtime_error("the HyperLogLog precision must be between 4 and 16");
+    }
+    m_renumber_priorities = parser.options.count("renumber-priorities");
+    m_compress_priorities = parser.options.count("compress-priorities");
+    if(parser.options.count("threads"))
+    {
+      set_num_threads(parser.option_argument_as<size_t>("threads"));
+    }
   }
 
   bool run()
@@ -91,7 +173,16 @@ public:
     parse_pgsolver(pg, is, timer());
     YAML::Emitter out;
 
-    report(pg, out, m_options);
+    if(m_compress_priorities || m_renumber_priorities)
+    {
+      const priority_compression_t compression = m_compress_priorities ? compress_priorities(pg)
+                                                                       : renumber_priorities(pg);
+      report(pg, out, m_options, &compression);
+    }
+    else
+    {
+      report(pg, out, m_options);
+    }
 
     os << out.c_str() << std::endl;
 
@@ -229,4 +229,37 @@ ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR(
   "131 0 0 131;\n"
 );
 
+const std::string
+MIXED_PRIORITIES(
+  "parity 4;\n"
+  "0 3 0 1;\n"
+  "1 2 1 2;\n"
+  "2 1 0 0, 1, 3;\n"
+  "3 4 1 4;\n"
+  "4 5 0 2;\n"
+);
+
+// Diamond 0 - 1,2 - 5, where the successors of 1 and 2 interleave.
+const std::string
+INTERLEAVED_DIAMOND(
+  "parity 5;\n"
+  "0 0 0 1, 2;\n"
+  "1 0 0 3, 5;\n"
+  "2 0 0 4, 5;\n"
+  "3 0 1 3;\n"
+  "4 0 1 4;\n"
+  "5 0 1 5;\n"
+);
+
+// Two SCCs {0, 1} and {2, 3} with sparse priorities; 4 is not on a cycle.
+const std::string
+SPARSE_PRIORITIES(
+  "parity 4;\n"
+  "0 2 0 1;\n"
+  "1 3 1 0;\n"
+  "2 6 0 3;\n"
+  "3 9 1 2;\n"
+  "4 8 0 0;\n"
+);
+
 #endif // _CASES_H
@@ -6,22 +6,37 @@
 #include "pgsolver_io.h"
 
 #include <boost/graph/wavefront.hpp>
+#include <boost/graph/strong_components.hpp>
 
 //#include "parsers/pgsolver.h"
 
 #include "cases.h"
 
 #include "degree.h"
+#include "graph_statistics.h"
 #include "bfs.h"
 #include "dfs.h"
 #include "diameter.h"
 #include "diamond.h"
+#include "simd.h"
+#include "motif.h"
 #include "girth.h"
+#include "sweep.h"
+#include "parity_girth.h"
 #include "neighbourhood.h"
+#include "hyperanf.h"
 #include "scc.h"
+#include "scc_decomposition.h"
+#include "attractor.h"
+#include "zielonka.h"
 #include "entanglement.h"
+#include "bucket_queue.h"
+#include "elimination_graph.h"
 #include "treewidth.h"
+#include "tree_decomposition.h"
 #include "alternation_depth.h"
+#include "priority_compression.h"
+#include "directed_elimination_graph.h"
 #include "kellywidth.h"
 
 template<typename ParityGame>
@@ -33,6 +48,21 @@ void load_graph(ParityGame& pg, const std::string& s)
   parse_pgsolver(pg, ss, timer);
 }
 
+/// \brief The k x k grid; vertex k*i + j is in row i and column j.
+undirected_parity_game_t grid(size_t k)
+{
+  undirected_parity_game_t result(k*k);
+  for(size_t i = 0; i < k; ++i)
+  {
+    for(size_t j = 0; j < k; ++j)
+    {
+      if(i + 1 < k) boost::add_edge(k*i + j, k*(i + 1) + j, result);
+      if(j + 1 < k) boost::add_edge(k*i + j, k*i + j + 1, result);
+    }
+  }
+  return result;
+}
+
 TEST(GraphStats, BUFFER_NODEADLOCK)
 {
   parity_game_t pg;
@@ -50,6 +80,53 @@ TEST(GraphStats, BUFFER_NODEADLOCK)
   EXPECT_EQ(2, max_out_degree(pg));
 }
 
+TEST(GraphStats, OnePass)
+{
+  const std::string games[] = { BUFFER_NODEADLOCK, ABP_NODEADLOCK, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR, MIXED_PRIORITIES };
+  for(const std::string& game: games)
+  {
+    parity_game_t pg;
+    load_graph(pg, game);
+    set_num_threads(3);
+    graph_statistics_t stats = graph_statistics(pg);
+    set_num_threads(0);
+    EXPECT_EQ(boost::num_vertices(pg), stats.vertices);
+    EXPECT_EQ(boost::num_edges(pg), stats.edges);
+    EXPECT_EQ(num_even_vertices(pg), stats.even_vertices);
+    EXPECT_EQ(num_odd_vertices(pg), stats.odd_vertices);
+    EXPECT_EQ(priorities(pg).size(), stats.priorities.size());
+    EXPECT_EQ(min_degree(pg), stats.degree.min);
+    EXPECT_EQ(max_degree(pg), stats.degree.max);
+    EXPECT_EQ(min_in_degree(pg), stats.in_degree.min);
+    EXPECT_EQ(max_in_degree(pg), stats.in_degree.max);
+    EXPECT_EQ(min_out_degree(pg), stats.out_degree.min);
+    EXPECT_EQ(max_out_degree(pg), stats.out_degree.max);
+    EXPECT_EQ(boost::num_edges(pg), stats.in_degree.sum);
+    EXPECT_EQ(boost::num_edges(pg), stats.out_degree.sum);
+    EXPECT_EQ(vertices_out_degree_n(pg, 1), stats.out_degree.histogram[1]);
+  }
+}
+
+TEST(GraphStats, SparsePriorities)
+{
+  parity_game_t pg(3);
+  pg[0].prio = 1000000000;
+  pg[1].prio = 3;
+  pg[2].prio = 1000000000;
+  pg[0].player = even;
+  pg[1].player = odd;
+  pg[2].player = even;
+  boost::add_edge(0, 1, pg);
+  boost::add_edge(0, 2, pg);
+  graph_statistics_t stats = graph_statistics(pg);
+  ASSERT_EQ(2, stats.priorities.size());
+  EXPECT_EQ(std::make_pair(priority_t(3), size_t(1)), stats.priorities[0]);
+  EXPECT_EQ(std::make_pair(priority_t(1000000000), size_t(2)), stats.priorities[1]);
+  EXPECT_EQ(2, stats.even_vertices);
+  EXPECT_EQ(2, stats.degree.histogram[1]);
+  EXPECT_EQ(1, stats.degree.histogram[2]);
+}
+
 TEST(GraphStats, ABP_NODEADLOCK)
 {
   parity_game_t pg;
@@ -238,6 +315,89 @@ TEST(Diamond, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
    */
 }
 
+TEST(Diamond, INTERLEAVED_DIAMOND)
+{
+  parity_game_t pg;
+  load_graph(pg, INTERLEAVED_DIAMOND);
+  diamond_count_t diamonds = diamond_count(pg);
+  EXPECT_EQ(1,diamonds.all);
+  EXPECT_EQ(1,diamonds.even);
+  EXPECT_EQ(0,diamonds.odd);
+}
+
+TEST(Diamond, Parallel)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
+  set_num_threads(4);
+  diamond_count_t diamonds = diamond_count(pg);
+  set_num_threads(0);
+  EXPECT_EQ(8,diamonds.all);
+  EXPECT_EQ(0,diamonds.even);
+  EXPECT_EQ(8,diamonds.odd);
+
+  // Splitting into the smallest possible tasks must not change the count.
+  csr_graph g = make_csr(pg);
+  std::vector<player_t> owner(boost::num_vertices(pg));
+  for(size_t v = 0; v < owner.size(); ++v)
+    owner[v] = pg[v].player;
+  std::vector<detail::diamond_task> tasks = detail::diamond_tasks(g, 1);
+  diamond_count_t split;
+  for(const detail::diamond_task& t: tasks)
+    for(size_t u = t.u_first; u < t.u_last; ++u)
+      detail::diamond_count(g, owner, u, t.row_first, t.row_last, split);
+  EXPECT_EQ(8,split.all);
+  EXPECT_EQ(8,split.odd);
+}
+
+TEST(Motifs, BUFFER_NODEADLOCK)
+{
+  parity_game_t pg;
+  load_graph(pg, BUFFER_NODEADLOCK);
+  std::vector<motif_pattern> patterns = default_motifs();
+  std::vector<motif_count_t> counts = motif_census(pg, patterns);
+  ASSERT_EQ(5, counts.size());
+  EXPECT_EQ(2, counts[0].all); // 1 <-> 2, 1 <-> 3
+  EXPECT_EQ(2, counts[0].odd);
+  EXPECT_EQ(0, counts[1].all);
+  EXPECT_EQ(1, counts[2].all); // 1 -> 2, 3
+  EXPECT_EQ(3, counts[3].all); // 0, 2, 3 -> 1
+  EXPECT_EQ(3, counts[3].even_priority);
+  EXPECT_EQ(1, counts[4].all);
+  EXPECT_EQ(1, counts[4].odd);
+}
+
+TEST(Motifs, MIXED_PRIORITIES)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  std::vector<motif_pattern> patterns;
+  patterns.push_back(motif_pattern(two_cycle));
+  patterns.push_back(motif_pattern(directed_triangle));
+  patterns.push_back(motif_pattern(out_star, 3));
+  std::vector<motif_count_t> counts = motif_census(pg, patterns);
+  EXPECT_EQ(1, counts[0].all); // 1 <-> 2
+  EXPECT_EQ(0, counts[0].even);
+  EXPECT_EQ(2, counts[1].all); // 0 -> 1 -> 2 -> 0, 2 -> 3 -> 4 -> 2
+  EXPECT_EQ(0, counts[1].odd_priority);
+  EXPECT_EQ(1, counts[2].all); // 2 -> 0, 1, 3
+}
+
+TEST(Intersection, Kernels)
+{
+  std::vector<uint32_t> a, b;
+  for(uint32_t i = 0; i < 100; ++i)
+  {
+    a.push_back(3*i);
+    b.push_back(2*i);
+  }
+  // multiples of 6 up to 198
+  EXPECT_EQ(34, intersection_size(&a[0], &a[0] + a.size(), &b[0], &b[0] + b.size()));
+  EXPECT_EQ(34, intersection_size(&b[0], &b[0] + b.size(), &a[0], &a[0] + a.size()));
+  EXPECT_EQ(1, intersection_size(&a[10], &a[11], &b[0], &b[0] + b.size())); // galloping
+  EXPECT_EQ(0, intersection_size(&a[0], &a[5], &b[50], &b[0] + b.size()));
+}
+
 TEST(Girth, BUFFER_NODEADLOCK)
 {
   parity_game_t pg;
@@ -259,6 +419,69 @@ TEST(Girth, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
   EXPECT_EQ(1, girth(pg));
 }
 
+TEST(Girth, Acyclic)
+{
+  // 0 -> 1 and 2 -> 1 are both edges into an already visited vertex, but
+  // they do not close a cycle.
+  parity_game_t pg(3);
+  boost::add_edge(0, 1, pg);
+  boost::add_edge(0, 2, pg);
+  boost::add_edge(2, 1, pg);
+  EXPECT_EQ(std::numeric_limits<size_t>::max(), girth(pg));
+}
+
+TEST(Sweep, ABP_NODEADLOCK)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_NODEADLOCK);
+  sweep_options options;
+  options.diameter = true;
+  options.girth = true;
+  options.neighbourhoods = true;
+  options.neighbourhoods_upto = 5;
+  set_num_threads(4);
+  sweep_result result = all_sources_sweep(pg, options);
+  set_num_threads(0);
+  EXPECT_EQ(30, result.diameter);
+  EXPECT_EQ(6, result.girth);
+  std::vector<neighbourhood_result> expected = accumulated_upto_kneighbourhood(pg, 5);
+  ASSERT_EQ(expected.size(), result.neighbourhoods.size());
+  for(size_t i = 0; i <= 5; ++i)
+  {
+    EXPECT_EQ(expected[i].min, result.neighbourhoods[i].min);
+    EXPECT_EQ(expected[i].max, result.neighbourhoods[i].max);
+    EXPECT_EQ(expected[i].sum, result.neighbourhoods[i].sum);
+  }
+}
+
+TEST(ParityGirth, ABP_NODEADLOCK)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_NODEADLOCK);
+  parity_girth_t girths = parity_girth(pg);
+  EXPECT_EQ(6, girths.even);
+  EXPECT_EQ(std::numeric_limits<size_t>::max(), girths.odd);
+}
+
+TEST(ParityGirth, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
+  parity_girth_t girths = parity_girth(pg);
+  EXPECT_EQ(1, girths.even);
+  EXPECT_EQ(std::numeric_limits<size_t>::max(), girths.odd);
+}
+
+TEST(ParityGirth, MIXED_PRIORITIES)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  parity_girth_t girths = parity_girth(pg);
+  EXPECT_EQ(2, girths.even); // 1 -> 2 -> 1
+  EXPECT_EQ(3, girths.odd);  // 0 -> 1 -> 2 -> 0
+  EXPECT_EQ(2, girth(pg));
+}
+
 TEST(SCC, BUFFER_NODEADLOCK)
 {
   parity_game_t pg;
@@ -289,6 +512,191 @@ TEST(SCC, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
   EXPECT_EQ(8, quotient_height(pg));
 }
 
+TEST(SCC, Statistics)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
+  scc_statistics_t stats = scc_statistics(pg);
+  EXPECT_EQ(23, stats.sccs);
+  EXPECT_EQ(18, stats.trivial_sccs);
+  EXPECT_EQ(1, stats.terminal_sccs);
+  EXPECT_EQ(8, stats.quotient_height);
+  EXPECT_EQ(8, stats.dag_depth);
+  EXPECT_EQ(74, stats.largest_scc);
+  EXPECT_DOUBLE_EQ(74.0/132.0, stats.largest_scc_fraction);
+  ASSERT_EQ(3, stats.sizes.size());
+  EXPECT_EQ(std::make_pair(size_t(10), size_t(4)), stats.sizes[1]);
+
+  std::vector<size_t> components;
+  const size_t n = scc_decomposition(pg, components);
+  const csr_graph quotient = condensation(make_csr(pg), components, n);
+  EXPECT_EQ(boost::num_edges(quotient_graph(pg, components, n)), quotient.num_edges());
+  EXPECT_EQ(4, count_elements_occurring_exactly_n_times(components, 10));
+}
+
+TEST(SCC, DagDepth)
+{
+  // The height of the quotient is measured from the SCC of vertex 0, the
+  // DAG depth is the longest path in the quotient.
+  parity_game_t pg(3);
+  boost::add_edge(1, 0, pg);
+  boost::add_edge(0, 2, pg);
+  scc_statistics_t stats = scc_statistics(pg);
+  EXPECT_EQ(2, stats.quotient_height);
+  EXPECT_EQ(3, stats.dag_depth);
+}
+
+TEST(SCC, Decomposition)
+{
+  const std::string games[] = { BUFFER_NODEADLOCK, ABP_NODEADLOCK, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR, MIXED_PRIORITIES, SPARSE_PRIORITIES };
+  for(const std::string& game: games)
+  {
+    parity_game_t pg;
+    load_graph(pg, game);
+    std::vector<size_t> expected(boost::num_vertices(pg));
+    const size_t nexpected = boost::strong_components(pg, &expected[0]);
+    std::vector<size_t> components;
+    set_num_threads(4);
+    const size_t ncomponents = scc_decomposition(pg, components);
+    set_num_threads(0);
+    ASSERT_EQ(nexpected, ncomponents);
+    ASSERT_EQ(expected.size(), components.size());
+    // Same partition, and components numbered by their smallest vertex.
+    size_t next = 0;
+    for(size_t u = 0; u < components.size(); ++u)
+    {
+      if(components[u] == next)
+        ++next;
+      EXPECT_LT(components[u], next);
+      for(size_t v = 0; v < u; ++v)
+        EXPECT_EQ(expected[u] == expected[v], components[u] == components[v]);
+    }
+  }
+}
+
+TEST(SCC, Colouring)
+{
+  // Without a sequential threshold, the colouring phase handles everything
+  // that trimming and forward-backward leave. A chain of 6-cycles, some with
+  // chords and some with edges back along the chain, leaves almost all
+  // vertices live after those phases.
+  parity_game_t pg(600);
+  for(size_t c = 0; c < 100; ++c)
+  {
+    for(size_t i = 0; i < 6; ++i)
+      boost::add_edge(6*c + i, 6*c + (i + 1) % 6, pg);
+    if(c % 3 == 0)
+      boost::add_edge(6*c + 3, 6*c, pg);
+    if(c + 1 < 100)
+      boost::add_edge(6*c + 2, 6*(c + 1) + (c*5) % 6, pg);
+    if(c >= 2 && c % 4 == 1)
+      boost::add_edge(6*c + 4, 6*(c - 2) + 1, pg);
+  }
+
+  std::vector<size_t> expected(boost::num_vertices(pg));
+  const size_t nexpected = boost::strong_components(pg, &expected[0]);
+  std::vector<size_t> components;
+  set_num_threads(4);
+  const size_t ncomponents = scc_decomposition(pg, components, 0);
+  set_num_threads(0);
+  ASSERT_EQ(nexpected, ncomponents);
+  for(size_t u = 0; u < components.size(); ++u)
+  {
+    for(size_t v = 0; v < u; ++v)
+      EXPECT_EQ(expected[u] == expected[v], components[u] == components[v]);
+  }
+
+  const std::string games[] = { ABP_NODEADLOCK, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR };
+  for(const std::string& game: games)
+  {
+    parity_game_t g;
+    load_graph(g, game);
+    expected.assign(boost::num_vertices(g), 0);
+    EXPECT_EQ(boost::strong_components(g, &expected[0]), scc_decomposition(g, components, 0));
+    for(size_t u = 0; u < components.size(); ++u)
+    {
+      for(size_t v = 0; v < u; ++v)
+        EXPECT_EQ(expected[u] == expected[v], components[u] == components[v]);
+    }
+  }
+}
+
+TEST(Attractor, MIXED_PRIORITIES)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  std::vector<attractor_statistics_t> attractors = top_priority_attractors(pg);
+  EXPECT_EQ(4, attractors[even].top_priority);
+  EXPECT_EQ(5, attractors[even].size);
+  EXPECT_EQ(3, attractors[even].depth); // {3}, {2}, {1, 4}, {0}
+  EXPECT_EQ(5, attractors[odd].top_priority);
+  EXPECT_EQ(2, attractors[odd].size);   // 2 can escape to 0 and 1
+  EXPECT_EQ(1, attractors[odd].depth);
+}
+
+TEST(Attractor, Subgame)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  const csr_graph fwd = make_csr(pg);
+  const csr_graph bwd = make_reverse_csr(fwd);
+  attractor_engine engine(pg, fwd, bwd);
+
+  // Without vertices 0 and 1, vertex 2 can only move to 3.
+  vertex_set subgame(5, true);
+  subgame.erase(0);
+  subgame.erase(1);
+  vertex_set target(5);
+  target.insert(4);
+  EXPECT_EQ(2, engine.attract(subgame, target, odd));
+  EXPECT_EQ(3, target.count());
+  EXPECT_TRUE(target.contains(2));
+  EXPECT_FALSE(target.contains(0));
+
+  // The engine can be reused on the full game.
+  vertex_set other(5);
+  other.insert(4);
+  EXPECT_EQ(1, engine.attract(vertex_set(5, true), other, odd));
+  EXPECT_EQ(2, other.count());
+  EXPECT_EQ(2, engine.calls());
+}
+
+TEST(Zielonka, MIXED_PRIORITIES)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  budget b;
+  zielonka_profile_t profile = zielonka_profile(pg, b);
+  EXPECT_TRUE(profile.complete);
+  // Even wins everywhere by eventually cycling between 1 and 2.
+  EXPECT_EQ(5, profile.winning[even]);
+  EXPECT_EQ(0, profile.winning[odd]);
+  EXPECT_EQ(6, profile.recursive_calls);
+  EXPECT_EQ(3, profile.max_depth);
+  EXPECT_EQ(5, profile.attractors);
+}
+
+TEST(Zielonka, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
+  budget b;
+  zielonka_profile_t profile = zielonka_profile(pg, b);
+  EXPECT_TRUE(profile.complete);
+  EXPECT_EQ(boost::num_vertices(pg), profile.winning[even] + profile.winning[odd]);
+}
+
+TEST(Zielonka, Budget)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  budget b(0, 2);
+  zielonka_profile_t profile = zielonka_profile(pg, b);
+  EXPECT_FALSE(profile.complete);
+  EXPECT_EQ(2, profile.recursive_calls);
+  EXPECT_TRUE(b.exhausted());
+}
+
 TEST(Neighbourhood, BUFFER_NODEADLOCK)
 {
   parity_game_t pg;
@@ -350,6 +758,89 @@ TEST(Neighbourhood, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
   EXPECT_EQ(0, min_kneighbourhood(pg, 5));
 }
 
+TEST(Neighbourhood, Accumulated)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_NODEADLOCK);
+  set_num_threads(4);
+  std::vector<neighbourhood_result> result = accumulated_upto_kneighbourhood(pg, 5);
+  set_num_threads(0);
+  ASSERT_EQ(6, result.size());
+  EXPECT_EQ(0, result[0].max);
+  EXPECT_EQ(93, result[1].sum); // no self-loops, so the out-degrees
+  EXPECT_EQ(16, result[5].max);
+  EXPECT_EQ(6, result[5].min);
+  EXPECT_EQ(13, upto_kneighbourhood(static_cast<size_t>(0), pg, 5)[5]); // 1; 2, 3; 4, 5; 6-9; 10-13
+
+  // Per-vertex queries on one engine agree with the accumulated result.
+  const csr_graph c = make_csr(pg);
+  detail::neighbourhood_engine engine(c);
+  size_t sum1 = 0, max5 = 0;
+  for(size_t v = 0; v < boost::num_vertices(pg); ++v)
+  {
+    sum1 += engine.kneighbourhood(v, 1);
+    max5 = std::max(max5, engine.kneighbourhood(v, 5));
+    EXPECT_EQ(engine.kneighbourhood(v, 5), kneighbourhood(v, pg, 5));
+  }
+  EXPECT_EQ(result[1].sum, sum1);
+  EXPECT_EQ(result[5].max, max5);
+}
+
+TEST(Neighbourhood, BitMatrix)
+{
+  const std::string games[] = { BUFFER_NODEADLOCK, ABP_NODEADLOCK, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR, MIXED_PRIORITIES };
+  for(const std::string& game: games)
+  {
+    parity_game_t pg;
+    load_graph(pg, game);
+    const csr_graph c = make_csr(pg);
+    const std::vector<neighbourhood_result> bfs = detail::accumulated_upto_kneighbourhood_bfs(c, 8);
+    const std::vector<neighbourhood_result> bits = detail::accumulated_upto_kneighbourhood_bit_matrix(c, 8, 64);
+    for(size_t i = 0; i <= 8; ++i)
+    {
+      EXPECT_EQ(bfs[i].min, bits[i].min);
+      EXPECT_EQ(bfs[i].max, bits[i].max);
+      EXPECT_EQ(bfs[i].sum, bits[i].sum);
+    }
+  }
+  EXPECT_EQ(0, detail::bit_matrix_width(1000, 1));
+  EXPECT_EQ(1024, detail::bit_matrix_width(1000, 3));
+  EXPECT_EQ(0, detail::bit_matrix_width(detail::max_vertices_for_bit_matrix + 1, 3));
+}
+
+TEST(Neighbourhood, Approximate)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_NODEADLOCK);
+  const size_t k = 5;
+  std::vector<neighbourhood_result> exact = accumulated_upto_kneighbourhood(pg, k);
+  std::vector<approximate_neighbourhood_result> approx = approximate_upto_kneighbourhood(pg, k, 10);
+  ASSERT_EQ(k+1, approx.size());
+  EXPECT_NEAR(0.0, approx[0].max, 0.01);
+  const double error = 3 * hyperloglog_relative_error(10);
+  for(size_t r = 1; r <= k; ++r)
+  {
+    const double avg = static_cast<double>(exact[r].sum)/boost::num_vertices(pg);
+    EXPECT_NEAR(avg, approx[r].avg, error * avg);
+    EXPECT_NEAR(exact[r].max, approx[r].max, error * exact[r].max);
+  }
+}
+
+TEST(Simd, MaxBytes)
+{
+  std::vector<uint8_t> dst(70), src(70);
+  for(size_t i = 0; i < dst.size(); ++i)
+  {
+    dst[i] = static_cast<uint8_t>(i);
+    src[i] = static_cast<uint8_t>(200 - i);
+  }
+  EXPECT_TRUE(max_bytes(dst.data(), src.data(), dst.size()));
+  for(size_t i = 0; i < dst.size(); ++i)
+    EXPECT_EQ(std::max(i, 200 - i), dst[i]);
+  EXPECT_FALSE(max_bytes(dst.data(), src.data(), dst.size()));
+  EXPECT_FALSE(max_bytes(dst.data(), src.data(), 0));
+}
+
 TEST(Wavefront, BUFFER_NODEADLOCK)
 {
   parity_game_t pg;
@@ -402,7 +893,8 @@ TEST(Treewidth, BUFFER_NODEADLOCK)
   load_graph(pg, BUFFER_NODEADLOCK);
   EXPECT_EQ(1, minor_min_width(pg));
   EXPECT_EQ(1, greedy_degree(pg));
-  //EXPECT_EQ(1, treewidth(pg));
+  EXPECT_EQ(1, greedy_fill_in(pg));
+  EXPECT_EQ(1, treewidth(pg));
 }
 
 TEST(Treewidth, ABP_NODEADLOCK)
@@ -411,7 +903,8 @@ TEST(Treewidth, ABP_NODEADLOCK)
   load_graph(pg, ABP_NODEADLOCK);
   EXPECT_EQ(2, minor_min_width(pg));
   EXPECT_EQ(2, greedy_degree(pg));
-  //EXPECT_EQ(2, treewidth(pg));
+  EXPECT_EQ(2, greedy_fill_in(pg));
+  EXPECT_EQ(2, treewidth(pg));
 }
 
 TEST(Treewidth, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
@@ -420,7 +913,357 @@ TEST(Treewidth, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
   load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
   EXPECT_EQ(2, minor_min_width(pg));
   EXPECT_EQ(2, greedy_degree(pg));
-  //EXPECT_EQ(2, treewidth(pg));
+  EXPECT_EQ(2, greedy_fill_in(pg));
+  EXPECT_EQ(2, treewidth(pg));
+}
+
+TEST(Treewidth, UpperBounds)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_NODEADLOCK);
+  std::vector<treewidth_upper_bound_t> bounds = treewidth_upper_bounds(pg);
+  ASSERT_EQ(5, bounds.size());
+  EXPECT_EQ(2, best_upper_bound(bounds).width);
+  for(const treewidth_upper_bound_t& bound: bounds)
+  {
+    EXPECT_LE(minor_min_width(pg), bound.width);
+    std::vector<size_t> ordering(bound.ordering);
+    std::sort(ordering.begin(), ordering.end());
+    for(size_t v = 0; v < ordering.size(); ++v)
+      EXPECT_EQ(v, ordering[v]);
+    EXPECT_EQ(boost::num_vertices(pg), ordering.size());
+  }
+  EXPECT_EQ(3, treewidth_upper_bounds(pg, false).size());
+}
+
+TEST(Treewidth, ChordalOrderings)
+{
+  // Two triangles 0 1 2 and 1 2 3 sharing an edge, and a pendant vertex 4;
+  // this graph is chordal, so the search based orderings are perfect.
+  undirected_parity_game_t pg(5);
+  boost::add_edge(0, 1, pg);
+  boost::add_edge(0, 2, pg);
+  boost::add_edge(1, 2, pg);
+  boost::add_edge(1, 3, pg);
+  boost::add_edge(2, 3, pg);
+  boost::add_edge(3, 4, pg);
+  for(const treewidth_upper_bound_t& bound: treewidth_upper_bounds(pg))
+    EXPECT_EQ(2, bound.width) << bound.method;
+}
+
+TEST(Treewidth, LowerBounds)
+{
+  // The 3x3 grid has treewidth 3; Ramachandramurthi only gives 2, the
+  // degeneracy is 2, and contraction gives 3. The reduction rules already
+  // certify 3, which raises all bounds.
+  const undirected_parity_game_t pg = grid(3);
+  elimination_graph g(pg);
+  EXPECT_EQ(2, detail::min_degree(g));
+  EXPECT_EQ(2, detail::ramachandramurthi(g));
+  EXPECT_EQ(3, detail::degeneracy_destructive(g, contract_min_degree));
+  g = elimination_graph(pg);
+  EXPECT_EQ(2, detail::degeneracy_destructive(g, delete_vertex));
+
+  std::vector<treewidth_lower_bound_t> bounds = treewidth_lower_bounds(pg);
+  ASSERT_EQ(8, bounds.size());
+  for(const treewidth_lower_bound_t& bound: bounds)
+    EXPECT_EQ(3, bound.width) << bound.method;
+  EXPECT_EQ(3, best_lower_bound(bounds).width);
+  EXPECT_EQ(minor_min_width(pg), bounds[3].width);
+  for(const treewidth_lower_bound_t& bound: bounds)
+    EXPECT_TRUE(bound.complete) << bound.method;
+  EXPECT_EQ(6, treewidth_lower_bounds(pg, false).size());
+
+  // With an exhausted budget, the runs from all start vertices are
+  // incomplete, but still give the bounds of the default start vertex. The
+  // reduction rules leave the 5x5 grid intact.
+  const undirected_parity_game_t large = grid(5);
+  budget none(0, 0);
+  bounds = treewidth_lower_bounds(large, true, &none);
+  ASSERT_EQ(8, bounds.size());
+  EXPECT_FALSE(bounds[6].complete);
+  EXPECT_FALSE(bounds[7].complete);
+  EXPECT_EQ(bounds[3].width, bounds[6].width);
+  EXPECT_EQ(bounds[5].width, bounds[7].width);
+}
+
+TEST(Treewidth, Kernel)
+{
+  // The Petersen graph is cubic without triangles, so the reduction rules
+  // only certify its minimum degree.
+  undirected_parity_game_t pg(10);
+  for(size_t i = 0; i < 5; ++i)
+  {
+    boost::add_edge(i, (i + 1) % 5, pg);
+    boost::add_edge(i, i + 5, pg);
+    boost::add_edge(i + 5, (i + 2) % 5 + 5, pg);
+  }
+  treewidth_kernel_t kernel = treewidth_kernel(pg);
+  EXPECT_EQ(10, kernel.vertices);
+  EXPECT_EQ(15, kernel.edges);
+  EXPECT_EQ(3, kernel.lower_bound);
+
+  // A pendant path and a pendant triangle reduce away, and do not raise the
+  // bound.
+  for(size_t i = 10; i < 13; ++i)
+    boost::add_edge(i - 1, i, pg);
+  boost::add_edge(0, 13, pg);
+  boost::add_edge(1, 13, pg);
+  kernel = treewidth_kernel(pg);
+  EXPECT_EQ(10, kernel.vertices);
+  EXPECT_EQ(15, kernel.edges);
+  EXPECT_EQ(3, kernel.lower_bound);
+
+  std::vector<treewidth_upper_bound_t> bounds = treewidth_upper_bounds(pg);
+  for(const treewidth_upper_bound_t& bound: bounds)
+  {
+    EXPECT_EQ(14, bound.ordering.size()) << bound.method;
+    EXPECT_LE(4, bound.width) << bound.method;
+  }
+  EXPECT_EQ(4, treewidth(pg));
+
+  // The bounds of a shared reduction are those of the graph.
+  const treewidth_reduction reduction(pg);
+  EXPECT_EQ(14, reduction.graph.num_vertices());
+  EXPECT_EQ(4, reduction.reduced.size());
+  EXPECT_EQ(kernel.vertices, reduction.statistics().vertices);
+  const std::vector<treewidth_upper_bound_t> shared = treewidth_upper_bounds(reduction);
+  ASSERT_EQ(bounds.size(), shared.size());
+  for(size_t i = 0; i < bounds.size(); ++i)
+  {
+    EXPECT_EQ(bounds[i].width, shared[i].width) << bounds[i].method;
+    EXPECT_EQ(bounds[i].ordering, shared[i].ordering) << bounds[i].method;
+  }
+  EXPECT_EQ(best_lower_bound(treewidth_lower_bounds(pg)).width, best_lower_bound(treewidth_lower_bounds(reduction)).width);
+  budget unlimited;
+  EXPECT_EQ(4, exact_treewidth(reduction, unlimited).upper_bound);
+
+  // Forests reduce to nothing.
+  undirected_parity_game_t path(4);
+  boost::add_edge(0, 1, path);
+  boost::add_edge(1, 2, path);
+  kernel = treewidth_kernel(path);
+  EXPECT_EQ(0, kernel.vertices);
+  EXPECT_EQ(1, kernel.lower_bound);
+}
+
+TEST(Treewidth, Pieces)
+{
+  // Two copies of K4 that share vertex 3 are the two biconnected components.
+  undirected_parity_game_t pg(7);
+  for(size_t i = 0; i < 4; ++i)
+  {
+    for(size_t j = i + 1; j < 4; ++j)
+    {
+      boost::add_edge(i, j, pg);
+      boost::add_edge(i + 3, j + 3, pg);
+    }
+  }
+  std::vector<graph_piece> pieces = detail::biconnected_components(elimination_graph(pg));
+  ASSERT_EQ(2, pieces.size());
+  for(const graph_piece& piece: pieces)
+  {
+    EXPECT_EQ(4, piece.graph.num_vertices());
+    EXPECT_EQ(6, piece.graph.num_edges());
+    EXPECT_TRUE(std::binary_search(piece.vertices.begin(), piece.vertices.end(), 3));
+  }
+  EXPECT_EQ(3, treewidth(pg));
+  for(const treewidth_upper_bound_t& bound: treewidth_upper_bounds(pg, true, true))
+  {
+    EXPECT_EQ(3, bound.width) << bound.method;
+    EXPECT_EQ(7, bound.ordering.size()) << bound.method;
+  }
+
+  // Two 4-cycles that share the edge 0 -- 1 are biconnected, and the edge is
+  // a clique separator between the two atoms.
+  undirected_parity_game_t cycles(6);
+  boost::add_edge(0, 1, cycles);
+  boost::add_edge(1, 2, cycles);
+  boost::add_edge(2, 3, cycles);
+  boost::add_edge(3, 0, cycles);
+  boost::add_edge(1, 4, cycles);
+  boost::add_edge(4, 5, cycles);
+  boost::add_edge(5, 0, cycles);
+  pieces = detail::biconnected_components(elimination_graph(cycles));
+  ASSERT_EQ(1, pieces.size());
+  std::vector<graph_piece> atoms = detail::clique_separator_atoms(pieces[0], detail::mcs_m_ordering(pieces[0].graph));
+  ASSERT_EQ(2, atoms.size());
+  for(const graph_piece& atom: atoms)
+  {
+    EXPECT_EQ(4, atom.graph.num_vertices());
+    EXPECT_EQ(4, atom.graph.num_edges());
+    EXPECT_EQ(0, atom.vertices[0]);
+    EXPECT_EQ(1, atom.vertices[1]);
+  }
+  for(const treewidth_lower_bound_t& bound: treewidth_lower_bounds(cycles, true, 0, true))
+    EXPECT_GE(2, bound.width) << bound.method;
+  EXPECT_EQ(2, treewidth(cycles));
+}
+
+TEST(Treewidth, Exact)
+{
+  // The 5x5 grid has treewidth 5; the best lower bound is only 4.
+  const undirected_parity_game_t pg = grid(5);
+  budget unlimited;
+  exact_treewidth_t exact = exact_treewidth(pg, unlimited);
+  EXPECT_TRUE(exact.complete);
+  EXPECT_EQ(5, exact.lower_bound);
+  EXPECT_EQ(5, exact.upper_bound);
+  EXPECT_LT(0, exact.nodes);
+  ASSERT_EQ(25, exact.ordering.size());
+  elimination_graph g(pg);
+  EXPECT_EQ(5, detail::elimination_width_destructive(g, exact.ordering));
+  EXPECT_EQ(5, treewidth(pg));
+
+  budget one_step(0, 1);
+  exact = exact_treewidth(pg, one_step);
+  EXPECT_FALSE(exact.complete);
+  EXPECT_LE(exact.lower_bound, 5);
+  EXPECT_GE(exact.upper_bound, 5);
+
+  // A cancelled budget also skips the expensive heuristics and the search,
+  // but still gives an ordering.
+  budget cancelled;
+  cancelled.cancel();
+  exact = exact_treewidth(pg, cancelled);
+  EXPECT_FALSE(exact.complete);
+  EXPECT_EQ(0, exact.nodes);
+  EXPECT_LE(exact.lower_bound, 5);
+  ASSERT_EQ(25, exact.ordering.size());
+  g = elimination_graph(pg);
+  EXPECT_EQ(exact.upper_bound, detail::elimination_width_destructive(g, exact.ordering));
+}
+
+TEST(Treewidth, Decomposition)
+{
+  // A path of length 2 and an isolated vertex.
+  undirected_parity_game_t path(4);
+  boost::add_edge(0, 1, path);
+  boost::add_edge(1, 2, path);
+  std::vector<size_t> ordering = {0, 1, 2, 3};
+  tree_decomposition_t td = tree_decomposition(path, ordering);
+  ASSERT_EQ(4, td.bags.size());
+  EXPECT_EQ(3, td.edges.size());
+  EXPECT_EQ(1, td.width());
+  EXPECT_TRUE(is_tree_decomposition(path, td));
+  std::ostringstream os;
+  print_pace_td(td, 4, os, ordering);
+  EXPECT_EQ("c ordering 1 2 3 4\n"
+            "s td 4 2 4\n"
+            "b 1 1 2\n"
+            "b 2 2 3\n"
+            "b 3 3\n"
+            "b 4 4\n"
+            "1 2\n"
+            "2 3\n"
+            "3 4\n", os.str());
+
+  // Bags that miss an edge, or a vertex, or are not connected for a vertex.
+  tree_decomposition_t broken = td;
+  broken.bags[1].pop_back();
+  EXPECT_FALSE(is_tree_decomposition(path, broken));
+  broken = td;
+  broken.bags[3].clear();
+  EXPECT_FALSE(is_tree_decomposition(path, broken));
+  broken = td;
+  broken.bags[3].push_back(1);
+  EXPECT_FALSE(is_tree_decomposition(path, broken));
+  broken = td;
+  broken.edges.pop_back();
+  EXPECT_FALSE(is_tree_decomposition(path, broken));
+
+  // The decomposition of the best upper bound on the 5x5 grid.
+  const undirected_parity_game_t pg = grid(5);
+  const treewidth_upper_bound_t best = best_upper_bound(treewidth_upper_bounds(pg));
+  td = tree_decomposition(pg, best.ordering);
+  EXPECT_EQ(25, td.bags.size());
+  EXPECT_EQ(best.width, td.width());
+  EXPECT_TRUE(is_tree_decomposition(pg, td));
+}
+
+TEST(Treewidth, Anytime)
+{
+  const undirected_parity_game_t pg = grid(5);
+  budget sixteen(0, 16);
+  anytime_upper_bound_t bound = anytime_treewidth_upper_bound(pg, sixteen);
+  EXPECT_EQ(16, bound.restarts);
+  EXPECT_LE(5, bound.width);
+  EXPECT_GE(best_upper_bound(treewidth_upper_bounds(pg)).width, bound.width);
+  EXPECT_LE(0, bound.time_to_best);
+  ASSERT_EQ(25, bound.ordering.size());
+  elimination_graph g(pg);
+  EXPECT_EQ(bound.width, detail::elimination_width_destructive(g, bound.ordering));
+
+  // If the budget is exhausted, the result is the best heuristic bound.
+  budget none(0, 0);
+  bound = anytime_treewidth_upper_bound(pg, none, false);
+  const treewidth_upper_bound_t best = best_upper_bound(treewidth_upper_bounds(pg, false));
+  EXPECT_EQ(0, bound.restarts);
+  EXPECT_EQ(best.width, bound.width);
+  EXPECT_EQ(best.ordering, bound.ordering);
+
+  // A given starting bound, e.g. one with clique separators, is kept.
+  const treewidth_reduction reduction(pg);
+  const treewidth_upper_bound_t atoms = best_upper_bound(treewidth_upper_bounds(reduction, true, true));
+  budget exhausted(0, 0);
+  bound = anytime_treewidth_upper_bound(reduction, atoms, exhausted);
+  EXPECT_EQ(0, bound.restarts);
+  EXPECT_EQ(atoms.width, bound.width);
+  EXPECT_EQ(atoms.ordering, bound.ordering);
+  budget eight(0, 8);
+  EXPECT_GE(atoms.width, anytime_treewidth_upper_bound(reduction, atoms, eight).width);
+}
+
+TEST(Treewidth, BucketQueue)
+{
+  bucket_queue queue(4, 3);
+  queue.push(0, 2);
+  queue.push(1, 1);
+  queue.push(2, 1);
+  queue.push(3, 3);
+  EXPECT_EQ(1, queue.min_key());
+  EXPECT_EQ(3, queue.max_key());
+  EXPECT_EQ(2, queue.top()); // last pushed among the minimal keys
+  queue.update(2, 3);
+  EXPECT_EQ(1, queue.pop());
+  EXPECT_EQ(0, queue.pop());
+  queue.erase(3);
+  EXPECT_EQ(1, queue.size());
+  EXPECT_EQ(3, queue.key(2));
+  EXPECT_FALSE(queue.contains(3));
+}
+
+TEST(Treewidth, EliminationGraph)
+{
+  // Path 0 - 1 - 2 - 3 with a self-loop on 0 and a parallel edge.
+  undirected_parity_game_t pg(4);
+  boost::add_edge(0, 0, pg);
+  boost::add_edge(0, 1, pg);
+  boost::add_edge(1, 2, pg);
+  boost::add_edge(2, 3, pg);
+  parity_game_t directed(4);
+  boost::add_edge(1, 0, directed);
+  boost::add_edge(0, 1, directed);
+  boost::add_edge(1, 2, directed);
+  boost::add_edge(3, 2, directed);
+
+  elimination_graph g(pg);
+  elimination_graph h(directed);
+  EXPECT_EQ(3, g.num_edges());
+  EXPECT_EQ(3, h.num_edges());
+  EXPECT_EQ(g.neighbours(1), h.neighbours(1));
+
+  size_t changed = 0;
+  g.eliminate(1, [&](size_t) { ++changed; });
+  EXPECT_EQ(2, changed);
+  EXPECT_TRUE(g.has_edge(0, 2));
+  EXPECT_TRUE(g.removed(1));
+  EXPECT_EQ(2, g.num_edges());
+
+  g.contract(2, 3, [](size_t) {});
+  EXPECT_EQ(2, g.num_vertices());
+  EXPECT_EQ(1, g.num_edges());
+  EXPECT_EQ(std::vector<csr_vertex_t>(1, 0), g.neighbours(2));
 }
 
 TEST(Kellywidth, BUFFER_NODEADLOCK)
@@ -444,6 +1287,60 @@ TEST(Kellywidth, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
   EXPECT_EQ(2, elimination_ordering(pg));
 }
 
+TEST(Kellywidth, Anytime)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_NODEADLOCK);
+  budget eight(0, 8);
+  anytime_upper_bound_t bound = anytime_kellywidth_upper_bound(pg, eight);
+  EXPECT_EQ(8, bound.restarts);
+  EXPECT_LE(1, bound.width);
+  EXPECT_EQ(boost::num_vertices(pg), bound.ordering.size());
+
+  directed_elimination_graph destructable_g(pg);
+  std::vector<size_t> ordering;
+  EXPECT_EQ(elimination_ordering(pg), detail::elimination_ordering_destructive(destructable_g, &ordering));
+  EXPECT_EQ(boost::num_vertices(pg), ordering.size());
+}
+
+TEST(Kellywidth, DirectedEliminationGraph)
+{
+  // 0 -> 1 -> 2 with 0 -> 2 already present, 1 <-> 3, and a self-loop on 2.
+  parity_game_t pg(4);
+  boost::add_edge(0, 1, pg);
+  boost::add_edge(1, 2, pg);
+  boost::add_edge(0, 2, pg);
+  boost::add_edge(1, 3, pg);
+  boost::add_edge(3, 1, pg);
+  boost::add_edge(2, 2, pg);
+  directed_elimination_graph g(pg);
+  EXPECT_EQ(2, g.out_degree(0));
+  EXPECT_EQ(2, g.out_degree(1));
+  EXPECT_EQ(1, g.out_degree(2));
+  EXPECT_TRUE(g.has_edge(2, 2));
+
+  std::vector<size_t> changed;
+  g.eliminate(1, [&](size_t u) { changed.push_back(u); });
+  std::sort(changed.begin(), changed.end());
+  EXPECT_EQ(std::vector<size_t>({0, 3}), changed);
+  EXPECT_EQ(3, g.num_vertices());
+  EXPECT_TRUE(g.removed(1));
+  EXPECT_EQ(std::vector<csr_vertex_t>({2, 3}), g.successors(0)); // 0 -> 2 is not added twice
+  EXPECT_EQ(std::vector<csr_vertex_t>({2}), g.successors(3));    // no self-loop 3 -> 3
+  EXPECT_EQ(std::vector<csr_vertex_t>({0, 3}), g.predecessors(2));
+  EXPECT_EQ(std::vector<csr_vertex_t>({0}), g.predecessors(3));
+  EXPECT_EQ(1, g.out_degree(2));
+
+  // Undirected edges count in both directions.
+  undirected_parity_game_t path(3);
+  boost::add_edge(0, 1, path);
+  boost::add_edge(1, 2, path);
+  directed_elimination_graph h(path);
+  EXPECT_EQ(2, h.out_degree(1));
+  EXPECT_EQ(std::vector<csr_vertex_t>({1}), h.predecessors(0));
+  EXPECT_EQ(1, elimination_ordering(path));
+}
+
 TEST(AlternationDepth, BUFFER_NODEADLOCK)
 {
   parity_game_t pg;
@@ -468,6 +1365,105 @@ TEST(AlternationDepth, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
   EXPECT_EQ(2,alternation_depth_priority_sorting(pg));
 }
 
+TEST(AlternationDepth, PerSCC)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
+  const csr_graph fwd = make_csr(pg);
+  const csr_graph bwd = make_reverse_csr(fwd);
+  std::vector<size_t> components;
+  const size_t sccs = scc_decomposition(fwd, bwd, components);
+  for(alternation_depth_ordering ordering: {vertex_index_ordering, priority_ordering})
+  {
+    alternation_depth_statistics_t ad = alternation_depth_statistics(pg, bwd, components, sccs, ordering);
+    EXPECT_EQ(2, ad.depth);
+    ASSERT_EQ(3, ad.histogram.size());
+    EXPECT_EQ(0, ad.histogram[0]);
+    EXPECT_EQ(sccs, ad.histogram[1] + ad.histogram[2]);
+    EXPECT_LT(0, ad.histogram[2]);
+  }
+}
+
+TEST(AlternationDepth, SparsePriorities)
+{
+  // A single SCC 0 -> 1 -> 2 -> 0 with priorities that are far apart.
+  parity_game_t pg(3);
+  pg[0].prio = 1000000; pg[0].player = even;
+  pg[1].prio = 7;       pg[1].player = odd;
+  pg[2].prio = 20;      pg[2].player = even;
+  boost::add_edge(0, 1, pg);
+  boost::add_edge(1, 2, pg);
+  boost::add_edge(2, 0, pg);
+  EXPECT_EQ(3, alternation_depth(pg));                  // 0 -> 1 -> 2 alternates twice
+  EXPECT_EQ(2, alternation_depth_priority_sorting(pg)); // 7 -> 20 alternates, 20 -> 1000000 does not
+}
+
+TEST(AlternationDepth, Nested)
+{
+  parity_game_t pg;
+  load_graph(pg, MIXED_PRIORITIES);
+  // {0,...,4} has top priority 5; without 4, {0, 1, 2} has top priority 3,
+  // and without 0, {1, 2} has top priority 2.
+  EXPECT_EQ(2, nested_alternation_depth(pg));
+
+  parity_game_t buffer;
+  load_graph(buffer, BUFFER_NODEADLOCK);
+  EXPECT_EQ(1, nested_alternation_depth(buffer));
+}
+
+TEST(AlternationDepth, NestedAcyclic)
+{
+  parity_game_t pg(2);
+  pg[0].prio = 0; pg[0].player = even;
+  pg[1].prio = 1; pg[1].player = odd;
+  boost::add_edge(0, 1, pg);
+  EXPECT_EQ(0, nested_alternation_depth(pg));
+  boost::add_edge(1, 1, pg);
+  EXPECT_EQ(1, nested_alternation_depth(pg));
+  boost::add_edge(1, 0, pg);
+  EXPECT_EQ(1, nested_alternation_depth(pg)); // without 1, vertex 0 is not on a cycle
+  boost::add_edge(0, 0, pg);
+  EXPECT_EQ(2, nested_alternation_depth(pg));
+}
+
+TEST(PriorityCompression, Renumber)
+{
+  parity_game_t pg;
+  load_graph(pg, SPARSE_PRIORITIES);
+  priority_compression_t result = renumber_priorities(pg);
+  EXPECT_EQ(5, result.before);
+  EXPECT_EQ(4, result.after);
+  EXPECT_EQ(0, pg[0].prio);
+  EXPECT_EQ(1, pg[1].prio);
+  EXPECT_EQ(2, pg[2].prio);
+  EXPECT_EQ(3, pg[3].prio);
+  EXPECT_EQ(2, pg[4].prio); // 6 and 8 are merged
+}
+
+TEST(PriorityCompression, Compress)
+{
+  parity_game_t pg;
+  load_graph(pg, SPARSE_PRIORITIES);
+  priority_compression_t result = compress_priorities(pg);
+  EXPECT_EQ(5, result.before);
+  EXPECT_EQ(2, result.after);
+  EXPECT_EQ(0, pg[0].prio);
+  EXPECT_EQ(1, pg[1].prio);
+  EXPECT_EQ(0, pg[2].prio);
+  EXPECT_EQ(1, pg[3].prio);
+  EXPECT_EQ(0, pg[4].prio);
+}
+
+TEST(PriorityCompression, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR)
+{
+  parity_game_t pg;
+  load_graph(pg, ABP_READ_THEN_EVENTUALLY_SEND_IF_FAIR);
+  priority_compression_t result = compress_priorities(pg);
+  EXPECT_EQ(3, result.before);
+  EXPECT_GE(result.before, result.after);
+  EXPECT_EQ(2, alternation_depth(pg));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   //cpplogging::logger::set_reporting_level(cpplogging::debug);